@@ -0,0 +1,1178 @@
+// Measures SHA-2 implementations; results are printed as tables and optionally written to a JSON file, so that
+// they can be kept as a baseline. Sections:
+// - throughput of all algorithms for message sizes from 0 B up to 1 GiB,
+// - per-call latency of short messages of 0 to 111 bytes,
+// - fixed length hashing of digest sized messages (Merkle tree nodes, hash chains),
+// - PBKDF2 iterations per second for a single key and for a batch of keys,
+// - lookups in a frozen map compared to std::unordered_map,
+// - multi-buffer batches compared to hashing messages one by one,
+// - hashing of string columns in rows/s,
+// - p50/p99 latency of jobs aggregated into multi-buffer batches at various submission rates,
+// - scaling of the tree hash with the number of threads,
+// - time spent reading and hashing a file with reads overlapped with hashing.
+//
+// Usage: benchmarks [--json <file>] [--max-size <bytes>] [--min-time <seconds>] [--filter <algorithm>]
+
+#include <columnar.hpp>
+#include <fixed_length.hpp>
+#include <frozen_map.hpp>
+#include <job_manager.hpp>
+#include <multi_buffer.hpp>
+#include <pbkdf2.hpp>
+#include <sha2.hpp>
+#include <tree_hash.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if JSRIBAR_SHA2_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#if defined(JSRIBAR_SHA2_BENCHMARK_OPENSSL)
+#include <openssl/evp.h>
+#endif
+
+#if defined(JSRIBAR_SHA2_BENCHMARK_FILE)
+#include <file_hash.hpp>
+
+#include <filesystem>
+#include <fstream>
+#endif
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+// Message sizes include block boundaries of SHA-224/SHA-256 (55, 56, 64, 65) and SHA-384/SHA-512 (111, 112, 128).
+constexpr size_t sizes_k[]{
+    0, 1, 32, 55, 56, 63, 64, 65, 111, 112, 127, 128, 129, 256, 1024, 4096, 16384, 65536,
+    size_t(1) << 20, size_t(16) << 20, size_t(256) << 20, size_t(1) << 30
+};
+
+struct options_t
+{
+    std::string json_file;
+    size_t max_size{ size_t(1) << 30 };
+    double min_time{ 0.2 };
+    std::string filter;
+};
+
+struct result_t
+{
+    std::string implementation;
+    std::string algorithm;
+    std::string kernel;
+    size_t size;
+    uint64_t iterations;
+    double ns_per_op;
+    // Cycles are measured with time stamp counter and are not available on other platforms.
+    double cycles_per_op;
+};
+
+uint64_t cycles()
+{
+#if JSRIBAR_SHA2_X86
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Short messages of up to 111 bytes fit into a single SHA-384/SHA-512 message block (55 bytes for SHA-224/SHA-256)
+// together with the padding. Since each size is measured, latency is measured for a fraction of the minimum time.
+constexpr size_t max_short_size_k{ 111 };
+constexpr double latency_time_fraction_k{ 0.1 };
+
+struct pbkdf2_result_t
+{
+    std::string implementation;
+    std::string algorithm;
+    std::string kernel;
+    // Number of keys derived at once, each one digest long.
+    size_t keys;
+    double iterations_per_s;
+};
+
+// Iterations of each PBKDF2 derivation measured.
+constexpr uint32_t pbkdf2_iterations_k{ 4096 };
+
+// Frozen map lookups are measured for keys "key0" to "key255"; the map is built at compile time.
+constexpr size_t lookup_keys_k{ 256 };
+
+constexpr auto lookup_key_chars_k = []
+{
+    std::array<std::array<char, 8>, lookup_keys_k> keys{};
+    for (size_t i = 0; i < lookup_keys_k; ++i)
+    {
+        auto& key = keys[i];
+        key = { 'k', 'e', 'y' };
+        size_t length = 3;
+        for (size_t divisor = 100; divisor > 0; divisor /= 10)
+        {
+            if (i >= divisor || divisor == 1)
+            {
+                key[length++] = char('0' + i / divisor % 10);
+            }
+        }
+    }
+    return keys;
+}();
+
+constexpr std::array<std::pair<std::string_view, uint32_t>, lookup_keys_k> lookup_entries()
+{
+    std::array<std::pair<std::string_view, uint32_t>, lookup_keys_k> entries{};
+    for (size_t i = 0; i < lookup_keys_k; ++i)
+    {
+        entries[i] = { std::string_view{ lookup_key_chars_k[i].data() }, uint32_t(i) };
+    }
+    return entries;
+}
+
+struct lookup_result_t
+{
+    std::string implementation;
+    std::string algorithm;
+    size_t keys;
+    double ns_per_lookup;
+};
+
+// Batches of messages of equal size are hashed with hash_batch() and one by one in a loop.
+constexpr size_t batch_messages_k{ 256 };
+constexpr size_t batch_sizes_k[]{ 32, 64, 256, 1024, 4096 };
+
+struct batch_result_t
+{
+    std::string implementation;
+    std::string algorithm;
+    std::string kernel;
+    size_t size;
+    double gb_per_s;
+};
+
+// Columns of 1M rows with lengths 0 to 200 bytes are hashed row by row and with hash_column().
+constexpr size_t column_rows_k{ size_t(1) << 20 };
+constexpr size_t column_max_row_k{ 200 };
+
+struct column_result_t
+{
+    std::string implementation;
+    std::string algorithm;
+    std::string kernel;
+    size_t threads;
+    double rows_per_s;
+    double gb_per_s;
+};
+
+// Jobs of 64-byte messages are submitted at given rates (0 meaning as fast as possible) to managers with given
+// deadlines.
+constexpr size_t job_message_size_k{ 64 };
+constexpr double job_rates_k[]{ 1e5, 1e6, 0 };
+constexpr std::chrono::microseconds job_deadlines_k[]{ std::chrono::microseconds{ 10 }, std::chrono::microseconds{ 100 } };
+
+struct job_result_t
+{
+    std::string implementation;
+    std::string algorithm;
+    double deadline_us;
+    double offered_per_s;
+    double completed_per_s;
+    double p50_us;
+    double p99_us;
+};
+
+// File of up to 256 MiB is hashed with each reader, with a single buffer (reads and hashing are serialized) and
+// with several buffers in flight; with O_DIRECT the reads are not served from the page cache.
+constexpr size_t file_max_size_k{ size_t(256) << 20 };
+constexpr size_t file_buffers_k[]{ 1, 4 };
+
+struct file_result_t
+{
+    std::string algorithm;
+    std::string reader;
+    bool direct;
+    size_t buffers;
+    size_t size;
+    double total_ms;
+    double wait_ms;
+    double hash_ms;
+    double gb_per_s;
+};
+
+// Tree hash of the message appended several times (4 GiB for the default maximum size) is evaluated by 1, 2,
+// 4, ... threads up to the number of hardware threads, with and without the linear digest. With file benchmarks,
+// the message is also written to a file that is streamed to the hasher in 1 MiB blocks by update_from_file().
+constexpr size_t tree_repetitions_k{ 4 };
+
+struct tree_result_t
+{
+    std::string algorithm;
+    std::string kernel;
+    std::string input;
+    bool linear;
+    size_t threads;
+    size_t size;
+    double gb_per_s;
+    double speedup;
+};
+
+// Prevents compiler from optimizing away evaluation of digests.
+volatile uint8_t sink;
+
+// Repeats hashing until minimum time has elapsed.
+template <typename HashFunction>
+result_t measure(const options_t& options, size_t size, HashFunction hash)
+{
+    using clock = std::chrono::steady_clock;
+
+    // Clock is read once per batch of iterations, so that reading it does not add to the time of short messages.
+    // Batches are doubled until they take a noticeable fraction of the minimum time.
+    uint64_t iterations = 0;
+    uint64_t batch = 1;
+    const auto start_cycles = cycles();
+    const auto start = clock::now();
+    double elapsed = 0;
+    do
+    {
+        for (uint64_t i = 0; i < batch; ++i)
+        {
+            sink = sink ^ hash(size);
+        }
+        iterations += batch;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        if (elapsed < options.min_time / 16)
+        {
+            batch *= 2;
+        }
+    } while (elapsed < options.min_time);
+    const auto elapsed_cycles = cycles() - start_cycles;
+
+    result_t result{};
+    result.size = size;
+    result.iterations = iterations;
+    result.ns_per_op = elapsed * 1e9 / double(iterations);
+    result.cycles_per_op = double(elapsed_cycles) / double(iterations);
+    return result;
+}
+
+double cycles_per_byte(const result_t& result)
+{
+    return result.size > 0 ? result.cycles_per_op / double(result.size) : 0;
+}
+
+double gb_per_s(const result_t& result)
+{
+    return double(result.size) / result.ns_per_op;
+}
+
+template <typename Sha>
+void benchmark(const options_t& options, std::string_view name, const std::vector<char>& message, std::vector<result_t>& results)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos)
+    {
+        return;
+    }
+
+    for (auto size : sizes_k)
+    {
+        if (size > options.max_size)
+        {
+            break;
+        }
+        auto result = measure(options, size, [&](size_t size) { return Sha{ message.data(), size }.digest()[0]; });
+        result.implementation = "sha2";
+        result.algorithm = name;
+        result.kernel = kernel_name(Sha::kernel());
+        results.push_back(result);
+    }
+}
+
+// Per-call latency of hashing short messages, for each size from 0 to max_short_size_k.
+template <typename Sha>
+void benchmark_latency(const options_t& options, std::string_view name, const std::vector<char>& message, std::vector<result_t>& results)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos)
+    {
+        return;
+    }
+
+    auto latency_options{ options };
+    latency_options.min_time = options.min_time * latency_time_fraction_k;
+    for (size_t size = 0; size <= std::min(max_short_size_k, options.max_size); ++size)
+    {
+        auto result = measure(latency_options, size, [&](size_t size) { return Sha{ message.data(), size }.digest()[0]; });
+        result.implementation = "sha2";
+        result.algorithm = name;
+        result.kernel = kernel_name(Sha::kernel());
+        results.push_back(result);
+    }
+}
+
+// Hashes messages of N bytes with hash_fixed(); compare with results of the generic hasher for the same size.
+template <typename Sha, size_t N>
+void benchmark_fixed(const options_t& options, std::string_view name, const std::vector<char>& message, std::vector<result_t>& results)
+{
+    if ((!options.filter.empty() && name.find(options.filter) == std::string_view::npos) || N > options.max_size)
+    {
+        return;
+    }
+
+    const auto bytes = reinterpret_cast<const uint8_t*>(message.data());
+    auto result = measure(options, N, [&](size_t) { return hash_fixed<Sha, N>(bytes)[0]; });
+    result.implementation = "sha2-fixed";
+    result.algorithm = name;
+    result.kernel = kernel_name(Sha::kernel());
+    results.push_back(result);
+}
+
+// Double SHA-256 of a 32-byte message (a link of a hash chain), by the generic hasher and by the fixed length one.
+void benchmark_sha256d(const options_t& options, const std::vector<char>& message, std::vector<result_t>& results)
+{
+    constexpr std::string_view name{ "SHA-256d" };
+    if ((!options.filter.empty() && name.find(options.filter) == std::string_view::npos) || options.max_size < 32)
+    {
+        return;
+    }
+
+    auto result = measure(options, 32, [&](size_t size)
+        {
+            const auto inner = sha256_t{ message.data(), size }.digest();
+            return sha256_t{ reinterpret_cast<const char*>(inner.data()), inner.size() }.digest()[0];
+        });
+    result.implementation = "sha2";
+    result.algorithm = name;
+    result.kernel = kernel_name(sha256_t::kernel());
+    results.push_back(result);
+
+    const auto bytes = reinterpret_cast<const uint8_t*>(message.data());
+    result = measure(options, 32, [&](size_t) { return hash_fixed<sha256_t>(hash_fixed<sha256_t, 32>(bytes))[0]; });
+    result.implementation = "sha2-fixed";
+    result.algorithm = name;
+    result.kernel = kernel_name(sha256_t::kernel());
+    results.push_back(result);
+}
+
+#if defined(JSRIBAR_SHA2_BENCHMARK_OPENSSL)
+
+void benchmark_openssl(const options_t& options, std::string_view name, const EVP_MD* md, const std::vector<char>& message, std::vector<result_t>& results)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos)
+    {
+        return;
+    }
+
+    for (auto size : sizes_k)
+    {
+        if (size > options.max_size)
+        {
+            break;
+        }
+        auto result = measure(options, size, [&](size_t size)
+            {
+                unsigned char digest[EVP_MAX_MD_SIZE];
+                unsigned int length = 0;
+                EVP_Digest(message.data(), size, digest, &length, md, nullptr);
+                return digest[0];
+            });
+        result.implementation = "openssl";
+        result.algorithm = name;
+        result.kernel = "openssl";
+        results.push_back(result);
+    }
+}
+
+#endif
+
+// Repeats key derivation until minimum time has elapsed. Derive function derives given number of keys.
+template <typename DeriveFunction>
+double measure_pbkdf2(const options_t& options, size_t keys, DeriveFunction derive)
+{
+    using clock = std::chrono::steady_clock;
+
+    uint64_t repetitions = 0;
+    const auto start = clock::now();
+    double elapsed = 0;
+    do
+    {
+        derive();
+        ++repetitions;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < options.min_time);
+
+    return double(repetitions) * double(keys) * pbkdf2_iterations_k / elapsed;
+}
+
+template <typename Sha>
+void benchmark_pbkdf2(const options_t& options, std::string_view name, std::vector<pbkdf2_result_t>& results)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos)
+    {
+        return;
+    }
+
+    for (size_t keys : { 1, 16 })
+    {
+        const std::vector<std::string_view> passwords(keys, "password");
+        const std::vector<std::string_view> salts(keys, "salt");
+        std::vector<typename Sha::message_digest_t> derived(keys);
+        std::vector<std::span<uint8_t>> key_views(derived.begin(), derived.end());
+
+        pbkdf2_result_t result;
+        result.iterations_per_s = measure_pbkdf2(options, keys, [&]
+            {
+                pbkdf2_batch<Sha>(passwords, salts, pbkdf2_iterations_k, key_views);
+                sink = sink ^ derived[0][0];
+            });
+        result.implementation = "sha2";
+        result.algorithm = name;
+        result.kernel = kernel_name(pbkdf2_detail::iteration_kernel<Sha>(keys));
+        result.keys = keys;
+        results.push_back(result);
+    }
+}
+
+#if defined(JSRIBAR_SHA2_BENCHMARK_OPENSSL)
+
+void benchmark_pbkdf2_openssl(const options_t& options, std::string_view name, const EVP_MD* md, std::vector<pbkdf2_result_t>& results)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos)
+    {
+        return;
+    }
+
+    pbkdf2_result_t result;
+    result.iterations_per_s = measure_pbkdf2(options, 1, [&]
+        {
+            unsigned char key[EVP_MAX_MD_SIZE];
+            PKCS5_PBKDF2_HMAC("password", 8, reinterpret_cast<const unsigned char*>("salt"), 4, int(pbkdf2_iterations_k), md, EVP_MD_size(md), key);
+            sink = sink ^ key[0];
+        });
+    result.implementation = "openssl";
+    result.algorithm = name;
+    result.kernel = "openssl";
+    result.keys = 1;
+    results.push_back(result);
+}
+
+#endif
+
+// Looks up all keys in turn, in a frozen map with full and with 8-byte fingerprints and in std::unordered_map.
+void benchmark_lookup(const options_t& options, std::vector<lookup_result_t>& results)
+{
+    constexpr std::string_view name{ "SHA-256" };
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos)
+    {
+        return;
+    }
+
+    static constexpr auto frozen = make_frozen_map<sha256_t, uint32_t>(lookup_entries());
+    static constexpr auto frozen_truncated = make_frozen_map<sha256_t, uint32_t, 8>(lookup_entries());
+    std::unordered_map<std::string, uint32_t> unordered;
+    std::vector<std::string> queries;
+    for (const auto& [key, value] : lookup_entries())
+    {
+        unordered.emplace(key, value);
+        queries.emplace_back(key);
+    }
+
+    size_t next = 0;
+    const auto query = [&] { return std::string_view{ queries[next++ % queries.size()] }; };
+
+    const auto measure_lookup = [&](std::string_view implementation, auto lookup)
+        {
+            const auto result = measure(options, 0, [&](size_t) { return uint8_t(lookup(query())); });
+            results.push_back({ std::string{ implementation }, std::string{ name }, lookup_keys_k, result.ns_per_op });
+        };
+    measure_lookup("sha2-frozen", [&](std::string_view key) { return *frozen.find(key); });
+    measure_lookup("sha2-frozen8", [&](std::string_view key) { return *frozen_truncated.find(key); });
+    measure_lookup("unordered", [&](std::string_view key) { return unordered.find(std::string{ key })->second; });
+}
+
+// Hashes batches of messages of each size with hash_batch() and one by one with the hasher.
+template <typename Sha>
+void benchmark_batch(const options_t& options, std::string_view name, const std::vector<char>& message, std::vector<batch_result_t>& results)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos)
+    {
+        return;
+    }
+
+    std::vector<typename Sha::message_digest_t> digests(batch_messages_k);
+    for (auto size : batch_sizes_k)
+    {
+        if (size > options.max_size || size * batch_messages_k > message.size())
+        {
+            break;
+        }
+        std::vector<std::string_view> messages;
+        for (size_t i = 0; i < batch_messages_k; ++i)
+        {
+            messages.emplace_back(message.data() + i * size, size);
+        }
+
+        const auto loop = measure(options, size * batch_messages_k, [&](size_t)
+            {
+                for (size_t i = 0; i < batch_messages_k; ++i)
+                {
+                    digests[i] = Sha{ messages[i] }.digest();
+                }
+                return digests.back()[0];
+            });
+        results.push_back({ "sha2", std::string{ name }, std::string{ kernel_name(Sha::kernel()) }, size, gb_per_s(loop) });
+
+        const auto batch = measure(options, size * batch_messages_k, [&](size_t)
+            {
+                hash_batch<Sha>(std::span<const std::string_view>{ messages }, std::span{ digests });
+                return digests.back()[0];
+            });
+        results.push_back({ "sha2-batch", std::string{ name }, std::string{ kernel_name(batch_kernel<Sha>()) }, size, gb_per_s(batch) });
+    }
+}
+
+// Hashes a column of random rows row by row with the hasher and with hash_column(), single threaded and in all
+// hardware threads.
+template <typename Sha>
+void benchmark_column(const options_t& options, std::string_view name, std::vector<column_result_t>& results)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos)
+    {
+        return;
+    }
+
+    std::vector<int64_t> offsets{ 0 };
+    uint64_t random = 1;
+    for (size_t i = 0; i < column_rows_k; ++i)
+    {
+        random = random * 6364136223846793005 + 1442695040888963407;
+        offsets.push_back(offsets.back() + int64_t((random >> 33) % (column_max_row_k + 1)));
+    }
+    std::vector<char> data(size_t(offsets.back()));
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = char(i * 31 + 7);
+    }
+    std::vector<typename Sha::message_digest_t> digests(column_rows_k);
+
+    const auto measure_column = [&](std::string_view implementation, std::string_view kernel, size_t threads, auto hash)
+        {
+            const auto result = measure(options, data.size(), [&](size_t)
+                {
+                    hash();
+                    return digests.back()[0];
+                });
+            results.push_back({ std::string{ implementation }, std::string{ name }, std::string{ kernel }, threads,
+                double(column_rows_k) * 1e9 / result.ns_per_op, gb_per_s(result) });
+        };
+
+    measure_column("sha2", kernel_name(Sha::kernel()), 1, [&]
+        {
+            for (size_t i = 0; i < column_rows_k; ++i)
+            {
+                digests[i] = Sha{ data.data() + offsets[i], size_t(offsets[i + 1] - offsets[i]) }.digest();
+            }
+        });
+    const auto hardware_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    for (size_t threads : { size_t(1), hardware_threads })
+    {
+        measure_column("sha2-column", kernel_name(batch_kernel<Sha>()), threads, [&]
+            {
+                hash_column<Sha>(data.data(), std::span<const int64_t>{ offsets }, std::span{ digests }, threads);
+            });
+        if (hardware_threads == 1)
+        {
+            break;
+        }
+    }
+}
+
+// Submits jobs from a single thread at a fixed rate and measures the time from submission to the completion
+// callback. For reference, jobs are also hashed directly by the submitting thread.
+template <typename Sha>
+void benchmark_jobs(const options_t& options, std::string_view name, const std::vector<char>& message, std::vector<job_result_t>& results)
+{
+    using clock = std::chrono::steady_clock;
+
+    if ((!options.filter.empty() && name.find(options.filter) == std::string_view::npos) || options.max_size < job_message_size_k)
+    {
+        return;
+    }
+
+    const std::string_view job_message{ message.data(), job_message_size_k };
+    const auto percentile = [](std::vector<double>& latencies, double fraction)
+        {
+            const auto nth = latencies.begin() + ptrdiff_t(fraction * double(latencies.size() - 1));
+            std::nth_element(latencies.begin(), nth, latencies.end());
+            return *nth;
+        };
+
+    for (auto deadline : job_deadlines_k)
+    {
+        for (auto rate : job_rates_k)
+        {
+            const size_t jobs = std::clamp(size_t((rate > 0 ? rate : 1e6) * options.min_time), size_t(1000), size_t(1) << 20);
+            std::vector<clock::time_point> submitted(jobs);
+            std::vector<double> latencies(jobs);
+            std::atomic<size_t> completed{ 0 };
+
+            const auto start = clock::now();
+            {
+                hash_job_manager_t<Sha> manager{ deadline };
+                for (size_t i = 0; i < jobs; ++i)
+                {
+                    if (rate > 0)
+                    {
+                        const auto due = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(double(i) / rate));
+                        while (clock::now() < due)
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                    submitted[i] = clock::now();
+                    manager.submit(job_message, [&, i](const typename Sha::message_digest_t& digest)
+                        {
+                            latencies[i] = std::chrono::duration<double, std::micro>(clock::now() - submitted[i]).count();
+                            sink = sink ^ digest[0];
+                            ++completed;
+                        });
+                }
+            }
+            const auto elapsed = std::chrono::duration<double>(clock::now() - start).count();
+
+            job_result_t result;
+            result.implementation = "sha2-jobs";
+            result.algorithm = name;
+            result.deadline_us = double(deadline.count());
+            result.offered_per_s = rate;
+            result.completed_per_s = double(completed) / elapsed;
+            result.p50_us = percentile(latencies, 0.5);
+            result.p99_us = percentile(latencies, 0.99);
+            results.push_back(result);
+        }
+    }
+
+    const auto direct = measure(options, job_message_size_k, [&](size_t size) { return Sha{ message.data(), size }.digest()[0]; });
+    job_result_t result;
+    result.implementation = "sha2";
+    result.algorithm = name;
+    result.deadline_us = 0;
+    result.offered_per_s = 0;
+    result.completed_per_s = 1e9 / direct.ns_per_op;
+    result.p50_us = direct.ns_per_op / 1e3;
+    result.p99_us = direct.ns_per_op / 1e3;
+    results.push_back(result);
+}
+
+void benchmark_tree(const options_t& options, const std::vector<char>& message, std::vector<tree_result_t>& results)
+{
+    const auto block = message.size() / tree_hash_chunk_size_k * tree_hash_chunk_size_k;
+    if ((!options.filter.empty() && std::string_view{ "SHA-256" }.find(options.filter) == std::string_view::npos) || block == 0)
+    {
+        return;
+    }
+
+    const auto hardware_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<size_t> thread_counts;
+    for (size_t threads = 1; threads < hardware_threads; threads *= 2)
+    {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(hardware_threads);
+
+    // Speedup is relative to a single thread with the same input.
+    const auto scale = [&](std::string_view input, bool linear, size_t size, const auto& hash)
+        {
+            double single_thread = 0;
+            for (const auto threads : thread_counts)
+            {
+                const auto result = measure(options, size, [&](size_t)
+                    {
+                        tree_hasher_t hasher{ threads, linear };
+                        hash(hasher);
+                        return hasher.finalize().tree[0];
+                    });
+                if (threads == 1)
+                {
+                    single_thread = gb_per_s(result);
+                }
+                results.push_back({ "SHA-256", std::string{ kernel_name(batch_kernel<sha256_t>()) }, std::string{ input }, linear, threads, size,
+                    gb_per_s(result), gb_per_s(result) / single_thread });
+            }
+        };
+
+    for (const bool linear : { false, true })
+    {
+        scale("memory", linear, block * tree_repetitions_k, [&](tree_hasher_t& hasher)
+            {
+                for (size_t i = 0; i < tree_repetitions_k; ++i)
+                {
+                    hasher.update(message.data(), block);
+                }
+            });
+    }
+
+#if defined(JSRIBAR_SHA2_BENCHMARK_FILE)
+    const auto path = std::filesystem::temp_directory_path() / "jsribar_sha2_benchmark_tree";
+    if (!std::ofstream{ path, std::ios::binary }.write(message.data(), std::streamsize(block)))
+    {
+        std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+        return;
+    }
+    scale("file", true, block, [&](tree_hasher_t& hasher)
+        {
+            file_hash_timing_t timing;
+            if (const auto error = update_from_file(hasher, path.c_str(), timing))
+            {
+                std::fprintf(stderr, "Cannot hash %s: %s\n", path.c_str(), error.message().c_str());
+            }
+        });
+    std::filesystem::remove(path);
+#endif
+}
+
+#if defined(JSRIBAR_SHA2_BENCHMARK_FILE)
+// Hashing time of the message in memory is reported as the compute-bound limit.
+template <typename Sha>
+void benchmark_file(const options_t& options, std::string_view name, const std::vector<char>& message, std::vector<file_result_t>& results)
+{
+    const auto size = std::min(message.size(), file_max_size_k);
+    if ((!options.filter.empty() && name.find(options.filter) == std::string_view::npos) || size == 0)
+    {
+        return;
+    }
+
+    const auto path = std::filesystem::temp_directory_path() / "jsribar_sha2_benchmark_file";
+    if (!std::ofstream{ path, std::ios::binary }.write(message.data(), std::streamsize(size)))
+    {
+        std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+        return;
+    }
+
+    const auto memory = measure(options, size, [&](size_t size) { return Sha{ message.data(), size }.digest()[0]; });
+    results.push_back({ std::string{ name }, "memory", false, 0, size, memory.ns_per_op / 1e6, 0, memory.ns_per_op / 1e6, gb_per_s(memory) });
+
+    std::vector<file_reader_t> readers{ file_reader_t::pread };
+    if (io_uring_available())
+    {
+        readers.push_back(file_reader_t::io_uring);
+    }
+    for (const auto reader : readers)
+    {
+        for (const bool direct : { false, true })
+        {
+            for (const auto buffers : file_buffers_k)
+            {
+                file_hash_timing_t sum{};
+                size_t iterations = 0;
+                do
+                {
+                    const auto result = hash_file<Sha>(path.c_str(), { reader, size_t(1) << 20, buffers, direct });
+                    if (result.error)
+                    {
+                        std::fprintf(stderr, "Cannot hash %s: %s\n", path.c_str(), result.error.message().c_str());
+                        std::filesystem::remove(path);
+                        return;
+                    }
+                    sink = sink ^ result.digest[0];
+                    sum.direct = result.timing.direct;
+                    sum.total += result.timing.total;
+                    sum.wait += result.timing.wait;
+                    sum.hash += result.timing.hash;
+                    ++iterations;
+                } while (std::chrono::duration<double>(sum.total).count() < options.min_time);
+
+                const auto ms = [&](std::chrono::nanoseconds time) { return double(time.count()) / 1e6 / double(iterations); };
+                results.push_back({ std::string{ name }, reader == file_reader_t::io_uring ? "io_uring" : "pread", sum.direct, buffers, size,
+                    ms(sum.total), ms(sum.wait), ms(sum.hash), double(size) * double(iterations) / double(sum.total.count()) });
+            }
+        }
+    }
+    std::filesystem::remove(path);
+}
+#endif
+
+void print(const std::vector<result_t>& results)
+{
+    std::printf("%-10s %-12s %-9s %12s %14s %12s %10s\n", "impl", "algorithm", "kernel", "size", "ns/op", "cycles/byte", "GB/s");
+    for (const auto& result : results)
+    {
+        std::printf("%-10s %-12s %-9s %12zu %14.1f %12.2f %10.3f\n", result.implementation.c_str(), result.algorithm.c_str(),
+            result.kernel.c_str(), result.size, result.ns_per_op, cycles_per_byte(result), gb_per_s(result));
+    }
+}
+
+// Prints latency in ns/call, with a row per size and a column per algorithm.
+void print_latency(const std::vector<result_t>& results)
+{
+    std::vector<std::string> algorithms;
+    for (const auto& result : results)
+    {
+        if (std::find(algorithms.begin(), algorithms.end(), result.algorithm) == algorithms.end())
+        {
+            algorithms.push_back(result.algorithm);
+        }
+    }
+    if (algorithms.empty())
+    {
+        return;
+    }
+
+    std::printf("\n%-6s", "size");
+    for (const auto& algorithm : algorithms)
+    {
+        std::printf(" %12s", algorithm.c_str());
+    }
+    std::printf("   (ns/call)\n");
+    for (size_t size = 0; size <= max_short_size_k; ++size)
+    {
+        bool found = false;
+        for (const auto& algorithm : algorithms)
+        {
+            const auto it = std::find_if(results.begin(), results.end(), [&](const result_t& result) { return result.algorithm == algorithm && result.size == size; });
+            if (it == results.end())
+            {
+                continue;
+            }
+            if (!found)
+            {
+                std::printf("%-6zu", size);
+                found = true;
+            }
+            std::printf(" %12.1f", it->ns_per_op);
+        }
+        if (found)
+        {
+            std::printf("\n");
+        }
+    }
+}
+
+void print_pbkdf2(const std::vector<pbkdf2_result_t>& results)
+{
+    std::printf("\n%-10s %-12s %-9s %6s %16s\n", "impl", "PBKDF2", "kernel", "keys", "iterations/s");
+    for (const auto& result : results)
+    {
+        std::printf("%-10s %-12s %-9s %6zu %16.0f\n", result.implementation.c_str(), result.algorithm.c_str(),
+            result.kernel.c_str(), result.keys, result.iterations_per_s);
+    }
+}
+
+void print_lookup(const std::vector<lookup_result_t>& results)
+{
+    std::printf("\n%-13s %-12s %6s %14s\n", "impl", "lookup", "keys", "ns/lookup");
+    for (const auto& result : results)
+    {
+        std::printf("%-13s %-12s %6zu %14.1f\n", result.implementation.c_str(), result.algorithm.c_str(), result.keys, result.ns_per_lookup);
+    }
+}
+
+void print_batch(const std::vector<batch_result_t>& results)
+{
+    std::printf("\n%-12s %-12s %-9s %10s %10s\n", "impl", "batch", "kernel", "size", "GB/s");
+    for (const auto& result : results)
+    {
+        std::printf("%-12s %-12s %-9s %10zu %10.3f\n", result.implementation.c_str(), result.algorithm.c_str(), result.kernel.c_str(),
+            result.size, result.gb_per_s);
+    }
+}
+
+void print_column(const std::vector<column_result_t>& results)
+{
+    std::printf("\n%-12s %-12s %-9s %7s %12s %10s\n", "impl", "column", "kernel", "threads", "Mrows/s", "GB/s");
+    for (const auto& result : results)
+    {
+        std::printf("%-12s %-12s %-9s %7zu %12.2f %10.3f\n", result.implementation.c_str(), result.algorithm.c_str(),
+            result.kernel.c_str(), result.threads, result.rows_per_s / 1e6, result.gb_per_s);
+    }
+}
+
+// Offered rate 0 means jobs submitted as fast as possible; the average latency of the direct hashing is given as
+// both percentiles.
+void print_jobs(const std::vector<job_result_t>& results)
+{
+    std::printf("\n%-10s %-12s %12s %12s %14s %10s %10s\n", "impl", "jobs", "deadline us", "offered/s", "completed/s", "p50 us", "p99 us");
+    for (const auto& result : results)
+    {
+        std::printf("%-10s %-12s %12.0f %12.0f %14.0f %10.2f %10.2f\n", result.implementation.c_str(), result.algorithm.c_str(),
+            result.deadline_us, result.offered_per_s, result.completed_per_s, result.p50_us, result.p99_us);
+    }
+}
+
+void print_tree(const std::vector<tree_result_t>& results)
+{
+    std::printf("\n%-12s %-9s %-6s %6s %7s %10s %10s %8s\n", "tree hash", "kernel", "input", "linear", "threads", "MiB", "GB/s", "speedup");
+    for (const auto& result : results)
+    {
+        std::printf("%-12s %-9s %-6s %6s %7zu %10zu %10.3f %8.2f\n", result.algorithm.c_str(), result.kernel.c_str(), result.input.c_str(),
+            result.linear ? "yes" : "no", result.threads, result.size >> 20, result.gb_per_s, result.speedup);
+    }
+}
+
+// If the hashing thread mostly waits for reads, hashing of the file is I/O-bound.
+void print_file(const std::vector<file_result_t>& results)
+{
+    std::printf("\n%-12s %-9s %6s %7s %10s %10s %10s %10s %10s\n", "file", "reader", "direct", "buffers", "MiB", "total ms", "wait ms", "hash ms", "GB/s");
+    for (const auto& result : results)
+    {
+        std::printf("%-12s %-9s %6s %7zu %10zu %10.2f %10.2f %10.2f %10.3f\n", result.algorithm.c_str(), result.reader.c_str(),
+            result.direct ? "yes" : "no", result.buffers, result.size >> 20, result.total_ms, result.wait_ms, result.hash_ms, result.gb_per_s);
+    }
+}
+
+bool write_json(const std::string& file_name, const std::vector<result_t>& results, const std::vector<result_t>& latency_results,
+    const std::vector<pbkdf2_result_t>& pbkdf2_results, const std::vector<lookup_result_t>& lookup_results,
+    const std::vector<batch_result_t>& batch_results, const std::vector<column_result_t>& column_results,
+    const std::vector<job_result_t>& job_results, const std::vector<file_result_t>& file_results, const std::vector<tree_result_t>& tree_results)
+{
+    auto file = std::fopen(file_name.c_str(), "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    const auto& features = cpu_features();
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"cpu_features\": { \"sha\": %s, \"avx2\": %s, \"bmi2\": %s, \"avx512f\": %s },\n",
+        features.sha ? "true" : "false", features.avx2 ? "true" : "false", features.bmi2 ? "true" : "false", features.avx512f ? "true" : "false");
+    std::fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& result = results[i];
+        std::fprintf(file, "    { \"implementation\": \"%s\", \"algorithm\": \"%s\", \"kernel\": \"%s\", \"size\": %zu, \"iterations\": %llu, "
+            "\"ns_per_op\": %.3f, \"cycles_per_byte\": %.4f, \"gb_per_s\": %.4f }%s\n",
+            result.implementation.c_str(), result.algorithm.c_str(), result.kernel.c_str(), result.size, (unsigned long long)result.iterations,
+            result.ns_per_op, cycles_per_byte(result), gb_per_s(result), i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ],\n");
+    std::fprintf(file, "  \"latency\": [\n");
+    for (size_t i = 0; i < latency_results.size(); ++i)
+    {
+        const auto& result = latency_results[i];
+        std::fprintf(file, "    { \"implementation\": \"%s\", \"algorithm\": \"%s\", \"kernel\": \"%s\", \"size\": %zu, \"ns_per_op\": %.3f }%s\n",
+            result.implementation.c_str(), result.algorithm.c_str(), result.kernel.c_str(), result.size, result.ns_per_op,
+            i + 1 < latency_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ],\n");
+    std::fprintf(file, "  \"pbkdf2\": [\n");
+    for (size_t i = 0; i < pbkdf2_results.size(); ++i)
+    {
+        const auto& result = pbkdf2_results[i];
+        std::fprintf(file, "    { \"implementation\": \"%s\", \"algorithm\": \"%s\", \"kernel\": \"%s\", \"keys\": %zu, \"iterations_per_s\": %.0f }%s\n",
+            result.implementation.c_str(), result.algorithm.c_str(), result.kernel.c_str(), result.keys, result.iterations_per_s,
+            i + 1 < pbkdf2_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ],\n");
+    std::fprintf(file, "  \"lookup\": [\n");
+    for (size_t i = 0; i < lookup_results.size(); ++i)
+    {
+        const auto& result = lookup_results[i];
+        std::fprintf(file, "    { \"implementation\": \"%s\", \"algorithm\": \"%s\", \"keys\": %zu, \"ns_per_lookup\": %.3f }%s\n",
+            result.implementation.c_str(), result.algorithm.c_str(), result.keys, result.ns_per_lookup, i + 1 < lookup_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ],\n");
+    std::fprintf(file, "  \"batch\": [\n");
+    for (size_t i = 0; i < batch_results.size(); ++i)
+    {
+        const auto& result = batch_results[i];
+        std::fprintf(file, "    { \"implementation\": \"%s\", \"algorithm\": \"%s\", \"kernel\": \"%s\", \"size\": %zu, \"gb_per_s\": %.4f }%s\n",
+            result.implementation.c_str(), result.algorithm.c_str(), result.kernel.c_str(), result.size, result.gb_per_s,
+            i + 1 < batch_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ],\n");
+    std::fprintf(file, "  \"columnar\": [\n");
+    for (size_t i = 0; i < column_results.size(); ++i)
+    {
+        const auto& result = column_results[i];
+        std::fprintf(file, "    { \"implementation\": \"%s\", \"algorithm\": \"%s\", \"kernel\": \"%s\", \"threads\": %zu, \"rows_per_s\": %.0f, \"gb_per_s\": %.4f }%s\n",
+            result.implementation.c_str(), result.algorithm.c_str(), result.kernel.c_str(), result.threads, result.rows_per_s, result.gb_per_s,
+            i + 1 < column_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ],\n");
+    std::fprintf(file, "  \"jobs\": [\n");
+    for (size_t i = 0; i < job_results.size(); ++i)
+    {
+        const auto& result = job_results[i];
+        std::fprintf(file, "    { \"implementation\": \"%s\", \"algorithm\": \"%s\", \"deadline_us\": %.0f, \"offered_per_s\": %.0f, "
+            "\"completed_per_s\": %.0f, \"p50_us\": %.3f, \"p99_us\": %.3f }%s\n",
+            result.implementation.c_str(), result.algorithm.c_str(), result.deadline_us, result.offered_per_s, result.completed_per_s,
+            result.p50_us, result.p99_us, i + 1 < job_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ],\n");
+    std::fprintf(file, "  \"file\": [\n");
+    for (size_t i = 0; i < file_results.size(); ++i)
+    {
+        const auto& result = file_results[i];
+        std::fprintf(file, "    { \"algorithm\": \"%s\", \"reader\": \"%s\", \"direct\": %s, \"buffers\": %zu, \"size\": %zu, "
+            "\"total_ms\": %.3f, \"wait_ms\": %.3f, \"hash_ms\": %.3f, \"gb_per_s\": %.4f }%s\n",
+            result.algorithm.c_str(), result.reader.c_str(), result.direct ? "true" : "false", result.buffers, result.size,
+            result.total_ms, result.wait_ms, result.hash_ms, result.gb_per_s, i + 1 < file_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ],\n");
+    std::fprintf(file, "  \"tree\": [\n");
+    for (size_t i = 0; i < tree_results.size(); ++i)
+    {
+        const auto& result = tree_results[i];
+        std::fprintf(file, "    { \"algorithm\": \"%s\", \"kernel\": \"%s\", \"input\": \"%s\", \"linear\": %s, \"threads\": %zu, \"size\": %zu, "
+            "\"gb_per_s\": %.4f, \"speedup\": %.3f }%s\n",
+            result.algorithm.c_str(), result.kernel.c_str(), result.input.c_str(), result.linear ? "true" : "false", result.threads, result.size,
+            result.gb_per_s, result.speedup, i + 1 < tree_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+bool parse_options(int argc, char* argv[], options_t& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view option{ argv[i] };
+        if (i + 1 == argc)
+        {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (option == "--json")
+        {
+            options.json_file = value;
+        }
+        else if (option == "--max-size")
+        {
+            options.max_size = std::strtoull(value, nullptr, 10);
+        }
+        else if (option == "--min-time")
+        {
+            options.min_time = std::strtod(value, nullptr);
+        }
+        else if (option == "--filter")
+        {
+            options.filter = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    options_t options;
+    if (!parse_options(argc, argv, options))
+    {
+        std::fprintf(stderr, "Usage: %s [--json <file>] [--max-size <bytes>] [--min-time <seconds>] [--filter <algorithm>]\n", argv[0]);
+        return 1;
+    }
+
+    const auto largest = *std::max_element(std::begin(sizes_k), std::end(sizes_k));
+    std::vector<char> message(std::min(options.max_size, largest));
+    for (size_t i = 0; i < message.size(); ++i)
+    {
+        message[i] = char(i * 31 + 7);
+    }
+
+    std::vector<result_t> results;
+    benchmark<sha224_t>(options, "SHA-224", message, results);
+    benchmark<sha256_t>(options, "SHA-256", message, results);
+    benchmark<sha384_t>(options, "SHA-384", message, results);
+    benchmark<sha512_t>(options, "SHA-512", message, results);
+    benchmark<sha512_224_t>(options, "SHA-512/224", message, results);
+    benchmark<sha512_256_t>(options, "SHA-512/256", message, results);
+
+    benchmark_fixed<sha256_t, 32>(options, "SHA-256", message, results);
+    benchmark_fixed<sha256_t, 64>(options, "SHA-256", message, results);
+    benchmark_fixed<sha512_t, 64>(options, "SHA-512", message, results);
+    benchmark_fixed<sha512_t, 128>(options, "SHA-512", message, results);
+    benchmark_sha256d(options, message, results);
+
+#if defined(JSRIBAR_SHA2_BENCHMARK_OPENSSL)
+    benchmark_openssl(options, "SHA-224", EVP_sha224(), message, results);
+    benchmark_openssl(options, "SHA-256", EVP_sha256(), message, results);
+    benchmark_openssl(options, "SHA-384", EVP_sha384(), message, results);
+    benchmark_openssl(options, "SHA-512", EVP_sha512(), message, results);
+    benchmark_openssl(options, "SHA-512/224", EVP_sha512_224(), message, results);
+    benchmark_openssl(options, "SHA-512/256", EVP_sha512_256(), message, results);
+#endif
+
+    std::vector<result_t> latency_results;
+    benchmark_latency<sha224_t>(options, "SHA-224", message, latency_results);
+    benchmark_latency<sha256_t>(options, "SHA-256", message, latency_results);
+    benchmark_latency<sha384_t>(options, "SHA-384", message, latency_results);
+    benchmark_latency<sha512_t>(options, "SHA-512", message, latency_results);
+    benchmark_latency<sha512_224_t>(options, "SHA-512/224", message, latency_results);
+    benchmark_latency<sha512_256_t>(options, "SHA-512/256", message, latency_results);
+
+    std::vector<pbkdf2_result_t> pbkdf2_results;
+    benchmark_pbkdf2<sha224_t>(options, "SHA-224", pbkdf2_results);
+    benchmark_pbkdf2<sha256_t>(options, "SHA-256", pbkdf2_results);
+    benchmark_pbkdf2<sha384_t>(options, "SHA-384", pbkdf2_results);
+    benchmark_pbkdf2<sha512_t>(options, "SHA-512", pbkdf2_results);
+    benchmark_pbkdf2<sha512_224_t>(options, "SHA-512/224", pbkdf2_results);
+    benchmark_pbkdf2<sha512_256_t>(options, "SHA-512/256", pbkdf2_results);
+
+#if defined(JSRIBAR_SHA2_BENCHMARK_OPENSSL)
+    benchmark_pbkdf2_openssl(options, "SHA-256", EVP_sha256(), pbkdf2_results);
+    benchmark_pbkdf2_openssl(options, "SHA-512", EVP_sha512(), pbkdf2_results);
+#endif
+
+    std::vector<lookup_result_t> lookup_results;
+    benchmark_lookup(options, lookup_results);
+
+    std::vector<batch_result_t> batch_results;
+    benchmark_batch<sha256_t>(options, "SHA-256", message, batch_results);
+    benchmark_batch<sha384_t>(options, "SHA-384", message, batch_results);
+    benchmark_batch<sha512_t>(options, "SHA-512", message, batch_results);
+
+    std::vector<column_result_t> column_results;
+    benchmark_column<sha256_t>(options, "SHA-256", column_results);
+    benchmark_column<sha512_t>(options, "SHA-512", column_results);
+
+    std::vector<job_result_t> job_results;
+    benchmark_jobs<sha256_t>(options, "SHA-256", message, job_results);
+    benchmark_jobs<sha512_t>(options, "SHA-512", message, job_results);
+
+    std::vector<tree_result_t> tree_results;
+    benchmark_tree(options, message, tree_results);
+
+    std::vector<file_result_t> file_results;
+#if defined(JSRIBAR_SHA2_BENCHMARK_FILE)
+    benchmark_file<sha256_t>(options, "SHA-256", message, file_results);
+#endif
+
+    print(results);
+    print_latency(latency_results);
+    print_pbkdf2(pbkdf2_results);
+    print_lookup(lookup_results);
+    print_batch(batch_results);
+    print_column(column_results);
+    print_jobs(job_results);
+    print_tree(tree_results);
+    print_file(file_results);
+
+    if (!options.json_file.empty()
+        && !write_json(options.json_file, results, latency_results, pbkdf2_results, lookup_results, batch_results, column_results, job_results,
+            file_results, tree_results))
+    {
+        std::fprintf(stderr, "Cannot write %s\n", options.json_file.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+# Measures the cost of evaluating digests at compile time: wall-clock time needed to compile compile_time.cpp
+# with STRINGS strings of each of LENGTHS, and the number of constant evaluation steps needed for a single
+# string, found by bisecting the compiler limit:
+#   - GCC:   -fconstexpr-ops-limit (default 33554432)
+#   - Clang: -fconstexpr-steps (default 1048576)
+#   - MSVC:  /constexpr:steps (default 100000)
+#
+# Usage: cmake -DCOMPILER=<path> -DCOMPILER_ID=<GNU|Clang|AppleClang|MSVC> -DSOURCE=<compile_time.cpp>
+#              -DINCLUDE_DIR=<include> [-DSTRINGS=<count>] [-DLENGTHS=<list>] [-DALGORITHMS=<list>]
+#              [-DOUTPUT=<file.json>] -P compile_time.cmake
+
+cmake_minimum_required(VERSION 3.28)
+
+foreach (required COMPILER COMPILER_ID SOURCE INCLUDE_DIR)
+    if (NOT DEFINED ${required})
+        message(FATAL_ERROR "${required} must be defined")
+    endif()
+endforeach()
+
+if (NOT DEFINED STRINGS)
+    set(STRINGS 100)
+endif()
+if (NOT DEFINED LENGTHS)
+    set(LENGTHS 64 1024 65536)
+endif()
+if (NOT DEFINED ALGORITHMS)
+    set(ALGORITHMS sha256_t sha512_t)
+endif()
+
+if (COMPILER_ID STREQUAL "MSVC")
+    set(compile_flags /nologo /std:c++20 /EHsc /Zs /I${INCLUDE_DIR})
+    set(define_flag /D)
+    set(limit_flag /constexpr:steps)
+elseif (COMPILER_ID STREQUAL "GNU")
+    set(compile_flags -std=c++20 -fsyntax-only -I${INCLUDE_DIR})
+    set(define_flag -D)
+    set(limit_flag -fconstexpr-ops-limit=)
+elseif (COMPILER_ID MATCHES "Clang")
+    set(compile_flags -std=c++20 -fsyntax-only -I${INCLUDE_DIR})
+    set(define_flag -D)
+    set(limit_flag -fconstexpr-steps=)
+else()
+    message(FATAL_ERROR "Unsupported compiler: ${COMPILER_ID}")
+endif()
+
+# Compiles the source and stores the result (TRUE on success) and elapsed time in microseconds.
+function(compile algorithm strings length limit result elapsed)
+    set(flags ${compile_flags}
+        ${define_flag}JSRIBAR_SHA2_ALGORITHM=${algorithm}
+        ${define_flag}JSRIBAR_SHA2_STRINGS=${strings}
+        ${define_flag}JSRIBAR_SHA2_LENGTH=${length})
+    if (limit)
+        list(APPEND flags ${limit_flag}${limit})
+    endif()
+
+    string(TIMESTAMP start "%s%f" UTC)
+    execute_process(
+        COMMAND ${COMPILER} ${flags} ${SOURCE}
+        RESULT_VARIABLE exit_code
+        OUTPUT_QUIET
+        ERROR_QUIET)
+    string(TIMESTAMP end "%s%f" UTC)
+
+    math(EXPR microseconds "${end} - ${start}")
+    set(${elapsed} ${microseconds} PARENT_SCOPE)
+    if (exit_code EQUAL 0)
+        set(${result} TRUE PARENT_SCOPE)
+    else()
+        set(${result} FALSE PARENT_SCOPE)
+    endif()
+endfunction()
+
+# Finds the smallest limit (within 1 %) that suffices for evaluating a digest of a single string.
+function(bisect_steps algorithm length steps)
+    set(low 0)
+    set(high 65536)
+    while (TRUE)
+        compile(${algorithm} 1 ${length} ${high} succeeded elapsed)
+        if (succeeded)
+            break()
+        endif()
+        set(low ${high})
+        math(EXPR high "${high} * 4")
+        if (high GREATER 68719476736)
+            set(${steps} "" PARENT_SCOPE)
+            return()
+        endif()
+    endwhile()
+
+    math(EXPR tolerance "${high} / 100")
+    math(EXPR range "${high} - ${low}")
+    while (range GREATER tolerance)
+        math(EXPR middle "(${low} + ${high}) / 2")
+        compile(${algorithm} 1 ${length} ${middle} succeeded elapsed)
+        if (succeeded)
+            set(high ${middle})
+        else()
+            set(low ${middle})
+        endif()
+        math(EXPR tolerance "${high} / 100")
+        math(EXPR range "${high} - ${low}")
+    endwhile()
+    set(${steps} ${high} PARENT_SCOPE)
+endfunction()
+
+message(STATUS "Compiler: ${COMPILER_ID} (${COMPILER}), ${STRINGS} strings per translation unit")
+message(STATUS "algorithm      length  default limits  compile time [s]  steps/string  steps/byte")
+
+set(json_entries "")
+foreach (algorithm IN LISTS ALGORITHMS)
+    foreach (length IN LISTS LENGTHS)
+        compile(${algorithm} ${STRINGS} ${length} "" within_default_limits elapsed)
+        bisect_steps(${algorithm} ${length} steps)
+
+        math(EXPR seconds "${elapsed} / 1000000")
+        # Leading 1 keeps zeros of the milliseconds part.
+        math(EXPR milliseconds "1000 + ${elapsed} % 1000000 / 1000")
+        string(SUBSTRING ${milliseconds} 1 3 milliseconds)
+
+        if (steps)
+            math(EXPR steps_per_byte "${steps} / ${length}")
+        else()
+            set(steps "n/a")
+            set(steps_per_byte "n/a")
+        endif()
+        if (within_default_limits)
+            set(fits "yes")
+            set(fits_json "true")
+        else()
+            set(fits "no")
+            set(fits_json "false")
+        endif()
+
+        if (steps STREQUAL "n/a")
+            set(steps_json "null")
+        else()
+            set(steps_json ${steps})
+        endif()
+        string(CONCAT entry "{ \"algorithm\": \"${algorithm}\", \"length\": ${length}, \"strings\": ${STRINGS}, "
+            "\"within_default_limits\": ${fits_json}, \"compile_time_us\": ${elapsed}, \"steps\": ${steps_json} }")
+        list(APPEND json_entries "${entry}")
+
+        set(row "")
+        foreach (column "${algorithm}:-14" "${length}:7" "${fits}:15" "${seconds}.${milliseconds}:17" "${steps}:13" "${steps_per_byte}:11")
+            string(REGEX MATCH "^(.*):(-?)([0-9]+)$" unused "${column}")
+            set(text "${CMAKE_MATCH_1}")
+            string(LENGTH "${text}" text_length)
+            math(EXPR padding_length "${CMAKE_MATCH_3} - ${text_length}")
+            set(padding "")
+            if (padding_length GREATER 0)
+                string(REPEAT " " ${padding_length} padding)
+            endif()
+            if (CMAKE_MATCH_2)
+                string(APPEND row "${text}${padding} ")
+            else()
+                string(APPEND row "${padding}${text} ")
+            endif()
+        endforeach()
+        message(STATUS "${row}")
+    endforeach()
+endforeach()
+
+if (DEFINED OUTPUT)
+    list(JOIN json_entries ",\n    " json)
+    file(WRITE ${OUTPUT} "{\n  \"compiler\": \"${COMPILER_ID}\",\n  \"results\": [\n    ${json}\n  ]\n}\n")
+endif()
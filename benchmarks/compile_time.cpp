@@ -0,0 +1,60 @@
+// Translation unit compiled by compile_time.cmake to measure the cost of evaluating digests at compile time.
+// It evaluates digests of JSRIBAR_SHA2_STRINGS distinct strings, each JSRIBAR_SHA2_LENGTH characters long, with
+// JSRIBAR_SHA2_ALGORITHM. Each digest is a separate constant expression, so that compiler limits on constant
+// evaluation (e.g. -fconstexpr-ops-limit, -fconstexpr-steps, /constexpr:steps) apply to a single string.
+
+#include <sha2.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#ifndef JSRIBAR_SHA2_STRINGS
+#define JSRIBAR_SHA2_STRINGS 1
+#endif
+
+#ifndef JSRIBAR_SHA2_LENGTH
+#define JSRIBAR_SHA2_LENGTH 1024
+#endif
+
+#ifndef JSRIBAR_SHA2_ALGORITHM
+#define JSRIBAR_SHA2_ALGORITHM sha256_t
+#endif
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+template <size_t index>
+constexpr auto make_string()
+{
+    std::array<char, JSRIBAR_SHA2_LENGTH> result{};
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        result[i] = char('a' + (i * 7 + index) % 26);
+    }
+    return result;
+}
+
+template <size_t index>
+constexpr auto string_k{ make_string<index>() };
+
+template <size_t index>
+constexpr auto digest_k{ JSRIBAR_SHA2_ALGORITHM{ std::string_view{ string_k<index>.data(), string_k<index>.size() } }.digest() };
+
+template <size_t... i>
+constexpr uint8_t checksum(std::index_sequence<i...>)
+{
+    return uint8_t((digest_k<i>[0] ^ ...));
+}
+
+constexpr auto checksum_k{ checksum(std::make_index_sequence<JSRIBAR_SHA2_STRINGS>{}) };
+
+}
+
+int main()
+{
+    return checksum_k;
+}
@@ -0,0 +1,93 @@
+# Embeds resource files into a target as constexpr byte arrays, together with a manifest of their digests that is
+# checked at compile time, so that integrity of embedded resources costs nothing at startup.
+#
+# Usage: include(cmake/embed_resources.cmake)
+#        jsribar_sha2_embed_resources(<target> HEADER <name.hpp> [NAMESPACE <namespace>] [ALGORITHM <SHA224|SHA256|SHA384|SHA512>]
+#                                     RESOURCES <file>...)
+#
+# Generated header (in the binary directory of the target, which is added to its include directories) defines
+# for each resource file, named by its file name converted to a C identifier (e.g. config_json for config.json):
+#   - <name>: constexpr std::array<uint8_t, N> with the content of the file,
+#   - <name>_digest: digest of <name> evaluated at compile time (see include/resource.hpp),
+# and a static_assert that compares each digest with the digest of the file evaluated by CMake. Header is
+# regenerated when a resource changes.
+#
+# The header can also be generated by running this file as a script:
+#   cmake -DOUTPUT=<header> -DNAMESPACE=<namespace> -DALGORITHM=<algorithm> "-DRESOURCES=<file>;..." -P embed_resources.cmake
+
+if (CMAKE_SCRIPT_MODE_FILE)
+    cmake_minimum_required(VERSION 3.28)
+
+    foreach (required OUTPUT NAMESPACE ALGORITHM RESOURCES)
+        if (NOT DEFINED ${required})
+            message(FATAL_ERROR "${required} must be defined")
+        endif()
+    endforeach()
+
+    string(TOLOWER ${ALGORITHM} function)
+
+    set(content "// Generated by embed_resources.cmake, do not edit.\n\n#pragma once\n\n#include <resource.hpp>\n\n")
+    string(APPEND content "#include <array>\n#include <cstdint>\n\nnamespace ${NAMESPACE}\n{\n")
+    foreach (resource ${RESOURCES})
+        get_filename_component(file_name ${resource} NAME)
+        string(MAKE_C_IDENTIFIER ${file_name} name)
+        file(SIZE ${resource} size)
+        file(${ALGORITHM} ${resource} expected)
+
+        # Content as hexadecimal bytes, 16 per line.
+        file(READ ${resource} bytes HEX)
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1, " bytes "${bytes}")
+        string(REGEX REPLACE "((0x[0-9a-f][0-9a-f], ){16})" "\\1\n    " bytes "${bytes}")
+        string(REGEX REPLACE "[ \n]+$" "" bytes "${bytes}")
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1, " expected "${expected}")
+        string(REGEX REPLACE ", $" "" expected "${expected}")
+
+        string(APPEND content "\n// ${file_name}\n")
+        string(APPEND content "inline constexpr std::array<uint8_t, ${size}> ${name}{\n    ${bytes}\n};\n\n")
+        string(APPEND content "inline constexpr auto ${name}_digest{ jsribar::cryptography::sha2::${function}_of<${name}> };\n\n")
+        string(APPEND content "static_assert(${name}_digest == decltype(${name}_digest){ ${expected} }, \"Digest of ${file_name} does not match the manifest\");\n")
+    endforeach()
+    string(APPEND content "\n}\n")
+
+    file(WRITE ${OUTPUT} "${content}")
+    return()
+endif()
+
+function(jsribar_sha2_embed_resources target)
+    cmake_parse_arguments(PARSE_ARGV 1 arg "" "HEADER;NAMESPACE;ALGORITHM" "RESOURCES")
+    if (NOT arg_HEADER OR NOT arg_RESOURCES)
+        message(FATAL_ERROR "jsribar_sha2_embed_resources: HEADER and RESOURCES must be given")
+    endif()
+    if (NOT arg_NAMESPACE)
+        set(arg_NAMESPACE resources)
+    endif()
+    if (NOT arg_ALGORITHM)
+        set(arg_ALGORITHM SHA256)
+    endif()
+    if (NOT arg_ALGORITHM MATCHES "^SHA(224|256|384|512)$")
+        message(FATAL_ERROR "jsribar_sha2_embed_resources: unsupported algorithm ${arg_ALGORITHM}")
+    endif()
+
+    set(resources)
+    foreach (resource ${arg_RESOURCES})
+        get_filename_component(resource ${resource} ABSOLUTE)
+        list(APPEND resources ${resource})
+    endforeach()
+
+    set(output_dir ${CMAKE_CURRENT_BINARY_DIR}/${target}_resources)
+    set(output ${output_dir}/${arg_HEADER})
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND ${CMAKE_COMMAND}
+            -DOUTPUT=${output}
+            -DNAMESPACE=${arg_NAMESPACE}
+            -DALGORITHM=${arg_ALGORITHM}
+            "-DRESOURCES=${resources}"
+            -P ${CMAKE_CURRENT_FUNCTION_LIST_FILE}
+        DEPENDS ${resources} ${CMAKE_CURRENT_FUNCTION_LIST_FILE}
+        COMMENT "Generating ${arg_HEADER}"
+        VERBATIM
+    )
+    target_sources(${target} PRIVATE ${output})
+    target_include_directories(${target} PRIVATE ${output_dir})
+endfunction()
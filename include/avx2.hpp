@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "cpu_features.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if JSRIBAR_SHA2_X86
+#include <immintrin.h>
+#endif
+
+// Single message compression for CPUs without SHA extensions. Message schedules of two consecutive
+// message blocks are evaluated at once, each block in one 128-bit half of AVX2 registers, and stored
+// with round constants added. Rounds are executed with general purpose registers, where BMI2 RORX
+// instruction evaluates rotations without modifying flags and overwriting the source.
+
+#if JSRIBAR_SHA2_X86
+
+namespace jsribar::cryptography::sha2::avx2
+{
+
+template <typename T>
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE __m256i add(__m256i a, __m256i b)
+{
+    if constexpr (sizeof(T) == 4)
+    {
+        return _mm256_add_epi32(a, b);
+    }
+    else
+    {
+        return _mm256_add_epi64(a, b);
+    }
+}
+
+template <typename T>
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE __m256i shift_right(__m256i value, int n)
+{
+    if constexpr (sizeof(T) == 4)
+    {
+        return _mm256_srli_epi32(value, n);
+    }
+    else
+    {
+        return _mm256_srli_epi64(value, n);
+    }
+}
+
+template <typename T>
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE __m256i right_rotate(__m256i value, int n)
+{
+    if constexpr (sizeof(T) == 4)
+    {
+        return _mm256_or_si256(_mm256_srli_epi32(value, n), _mm256_slli_epi32(value, 32 - n));
+    }
+    else
+    {
+        return _mm256_or_si256(_mm256_srli_epi64(value, n), _mm256_slli_epi64(value, 64 - n));
+    }
+}
+
+// Sum functions of the message schedule evaluated for all words in the register.
+template <typename T>
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE __m256i sum0(__m256i w)
+{
+    if constexpr (sizeof(T) == 4)
+    {
+        return _mm256_xor_si256(_mm256_xor_si256(right_rotate<T>(w, 7), right_rotate<T>(w, 18)), shift_right<T>(w, 3));
+    }
+    else
+    {
+        return _mm256_xor_si256(_mm256_xor_si256(right_rotate<T>(w, 1), right_rotate<T>(w, 8)), shift_right<T>(w, 7));
+    }
+}
+
+template <typename T>
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE __m256i sum1(__m256i w)
+{
+    if constexpr (sizeof(T) == 4)
+    {
+        return _mm256_xor_si256(_mm256_xor_si256(right_rotate<T>(w, 17), right_rotate<T>(w, 19)), shift_right<T>(w, 10));
+    }
+    else
+    {
+        return _mm256_xor_si256(_mm256_xor_si256(right_rotate<T>(w, 19), right_rotate<T>(w, 61)), shift_right<T>(w, 6));
+    }
+}
+
+// Sigma functions of the rounds.
+JSRIBAR_SHA2_ALWAYS_INLINE uint32_t sigma0(uint32_t h)
+{
+    return std::rotr(h, 2) ^ std::rotr(h, 13) ^ std::rotr(h, 22);
+}
+
+JSRIBAR_SHA2_ALWAYS_INLINE uint32_t sigma1(uint32_t h)
+{
+    return std::rotr(h, 6) ^ std::rotr(h, 11) ^ std::rotr(h, 25);
+}
+
+JSRIBAR_SHA2_ALWAYS_INLINE uint64_t sigma0(uint64_t h)
+{
+    return std::rotr(h, 28) ^ std::rotr(h, 34) ^ std::rotr(h, 39);
+}
+
+JSRIBAR_SHA2_ALWAYS_INLINE uint64_t sigma1(uint64_t h)
+{
+    return std::rotr(h, 14) ^ std::rotr(h, 18) ^ std::rotr(h, 41);
+}
+
+// Loads 16 bytes of the first block into the lower and 16 bytes of the second block into the upper half
+// of the register, converting big-endian words.
+template <typename T>
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE __m256i load(const uint8_t* first, const uint8_t* second)
+{
+    const auto byte_order = sizeof(T) == 4
+        ? _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL)
+        : _mm256_set_epi64x(0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL);
+    const auto lower = _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)));
+    const auto words = _mm256_inserti128_si256(lower, _mm_loadu_si128(reinterpret_cast<const __m128i*>(second)), 1);
+    return _mm256_shuffle_epi8(words, byte_order);
+}
+
+// Stores words of the first block from the lower half and words of the second block from the upper half
+// of the register, with round constants added.
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE void store(__m256i wk, void* first, void* second)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(first), _mm256_castsi256_si128(wk));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(second), _mm256_extracti128_si256(wk, 1));
+}
+
+// Executes rounds i..last-1. As in the portable implementation, positions of working variables in the array
+// are rotated instead of shifting them after each round.
+template <size_t i, size_t last, typename T, size_t n>
+JSRIBAR_SHA2_ALWAYS_INLINE void rounds(std::array<T, 8>& h, const std::array<T, n>& wk)
+{
+    constexpr auto at = [](size_t variable) { return (variable + 8 - i % 8) % 8; };
+
+    const T& a = h[at(0)];
+    const T& b = h[at(1)];
+    const T& c = h[at(2)];
+    T& d = h[at(3)];
+    const T& e = h[at(4)];
+    const T& f = h[at(5)];
+    const T& g = h[at(6)];
+    T& hh = h[at(7)];
+
+    const auto choice = g ^ (e & (f ^ g));
+    const auto temp1 = hh + sigma1(e) + choice + wk[i];
+    const auto majority = (a & b) | (c & (a | b));
+    const auto temp2 = sigma0(a) + majority;
+
+    d += temp1;
+    hh = temp1 + temp2;
+
+    if constexpr (i + 1 < last)
+    {
+        rounds<i + 1, last>(h, wk);
+    }
+}
+
+// Evaluates 16 bytes of message schedules of two message blocks, executes rounds of the first block that
+// use them and recursively continues with the remaining words. Each register holds 16 bytes (i.e. four
+// words for SHA-224/SHA-256, two words for SHA-384/SHA-512) of each block, so that the preceding 16 words
+// are kept in 4 or 8 registers, respectively. Registers are indexed with compile time constants, so that
+// they are not spilled to memory.
+template <size_t j, typename T, size_t n, size_t registers>
+JSRIBAR_SHA2_TARGET("avx2,bmi2") JSRIBAR_SHA2_ALWAYS_INLINE void schedule(__m256i (&x)[registers], const std::array<T, n>& k, std::array<std::array<T, n>, 2>& wk, std::array<T, 8>& h)
+{
+    constexpr size_t words = 16 / sizeof(T);
+    constexpr size_t i = j * words;
+
+    auto& w = x[j % registers];
+    if constexpr (j >= registers)
+    {
+        // w[i] = w[i - 16] + sum0(w[i - 15]) + w[i - 7] + sum1(w[i - 2])
+        const auto w15 = _mm256_alignr_epi8(x[(j + 1) % registers], w, sizeof(T));
+        const auto w7 = _mm256_alignr_epi8(x[(j + registers / 2 + 1) % registers], x[(j + registers / 2) % registers], sizeof(T));
+        const auto w2 = x[(j + registers - 1) % registers];
+        w = add<T>(add<T>(w, sum0<T>(w15)), w7);
+        if constexpr (sizeof(T) == 4)
+        {
+            // The first two words depend on the preceding register, the last two on the first two words.
+            w = add<T>(w, sum1<T>(_mm256_srli_si256(w2, 8)));
+            w = add<T>(w, sum1<T>(_mm256_slli_si256(w, 8)));
+        }
+        else
+        {
+            w = add<T>(w, sum1<T>(w2));
+        }
+    }
+
+    const auto constants = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&k[i])));
+    store(add<T>(w, constants), &wk[0][i], &wk[1][i]);
+
+    rounds<i, i + words>(h, wk[0]);
+
+    if constexpr (i + words < n)
+    {
+        schedule<j + 1>(x, k, wk, h);
+    }
+}
+
+// Compresses consecutive message blocks into the hash state, two blocks at a time: rounds of the first
+// block are interleaved with evaluation of both schedules, rounds of the second block follow. If the number
+// of blocks is odd, the schedule of the last block is evaluated in both halves of registers.
+template <typename RoundConstants, typename T>
+JSRIBAR_SHA2_TARGET("avx2,bmi2") void compress(std::array<T, 8>& h, const uint8_t* blocks, size_t count)
+{
+    static constexpr size_t block_size_k{ 16 * sizeof(T) };
+    static constexpr size_t rounds_k{ RoundConstants{}.size() };
+    static constexpr auto k = []
+    {
+        std::array<T, rounds_k> values{};
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = RoundConstants{}[i];
+        }
+        return values;
+    }();
+
+    alignas(32) std::array<std::array<T, rounds_k>, 2> wk;
+
+    while (count > 0)
+    {
+        const auto second = count > 1 ? blocks + block_size_k : blocks;
+
+        __m256i x[sizeof(T)];
+        for (size_t j = 0; j < sizeof(T); ++j)
+        {
+            x[j] = load<T>(blocks + j * 16, second + j * 16);
+        }
+
+        auto working = h;
+        schedule<0>(x, k, wk, working);
+        for (size_t i = 0; i < h.size(); ++i)
+        {
+            h[i] += working[i];
+        }
+        if (count == 1)
+        {
+            break;
+        }
+
+        working = h;
+        rounds<0, rounds_k>(working, wk[1]);
+        for (size_t i = 0; i < h.size(); ++i)
+        {
+            h[i] += working[i];
+        }
+
+        blocks += 2 * block_size_k;
+        count -= 2;
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "multi_buffer.hpp"
+#include "sha2.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Hashing of string columns stored as a contiguous data buffer and an offsets array (Arrow string and large
+// string layout): row i is data[offsets[i]] to data[offsets[i + 1]]. Digests are written to a dense column,
+// digest of row i at index i. Rows are passed to the multi-buffer engine (see hash_batch()) in chunks, so that
+// SIMD lanes are kept filled regardless of row lengths: a lane is refilled with the next row as soon as its row
+// is completed.
+
+namespace jsribar::cryptography::sha2
+{
+
+namespace columnar_detail
+{
+
+// Number of rows passed to hash_batch() at once. Views of the rows are kept on the stack.
+constexpr size_t chunk_rows_k{ 1024 };
+
+template <typename Sha, std::integral Offset>
+void hash_rows(const char* data, const Offset* offsets, size_t count, typename Sha::message_digest_t* digests)
+{
+    std::array<std::string_view, chunk_rows_k> rows;
+    for (size_t first = 0; first < count; first += chunk_rows_k)
+    {
+        const auto size = std::min(chunk_rows_k, count - first);
+        for (size_t i = 0; i < size; ++i)
+        {
+            const auto begin = offsets[first + i];
+            rows[i] = std::string_view{ data + begin, size_t(offsets[first + i + 1] - begin) };
+        }
+        hash_batch<Sha>(std::span<const std::string_view>{ rows.data(), size }, std::span{ digests + first, size });
+    }
+}
+
+}
+
+// Evaluates digests of all rows of a string column. Offsets contain count + 1 entries, where count is the number
+// of digests. If more than one thread is requested, the column is split into equal parts, each hashed in a
+// separate thread (the calling thread hashes the first one).
+template <typename Sha, std::integral Offset>
+void hash_column(const char* data, std::span<const Offset> offsets, std::span<typename Sha::message_digest_t> digests, size_t threads = 1)
+{
+    assert(offsets.size() == digests.size() + 1);
+
+    using columnar_detail::chunk_rows_k;
+
+    const auto count = digests.size();
+    // Parts are rounded up to whole chunks, so that threads are not left with tiny parts.
+    const auto rows_per_thread = (count + std::max<size_t>(threads, 1) - 1) / std::max<size_t>(threads, 1);
+    const auto part = (rows_per_thread + chunk_rows_k - 1) / chunk_rows_k * chunk_rows_k;
+    if (threads <= 1 || part >= count)
+    {
+        columnar_detail::hash_rows<Sha>(data, offsets.data(), count, digests.data());
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t first = part; first < count; first += part)
+    {
+        workers.emplace_back([=] { columnar_detail::hash_rows<Sha>(data, offsets.data() + first, std::min(part, count - first), digests.data() + first); });
+    }
+    columnar_detail::hash_rows<Sha>(data, offsets.data(), part, digests.data());
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+}
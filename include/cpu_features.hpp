@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Runtime detection of CPU features used by hardware accelerated implementations.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define JSRIBAR_SHA2_X86 1
+#else
+#define JSRIBAR_SHA2_X86 0
+#endif
+
+// Functions using instruction set extensions must be compiled for the target that supports them
+// with GCC and Clang. MSVC allows use of intrinsics anywhere.
+#if defined(__GNUC__) || defined(__clang__)
+#define JSRIBAR_SHA2_TARGET(features) __attribute__((target(features)))
+#else
+#define JSRIBAR_SHA2_TARGET(features)
+#endif
+
+// Helpers called from functions compiled for a specific target must be inlined into them to be
+// compiled for that target, too.
+#if defined(__GNUC__) || defined(__clang__)
+#define JSRIBAR_SHA2_ALWAYS_INLINE __attribute__((always_inline)) inline
+#elif defined(_MSC_VER)
+#define JSRIBAR_SHA2_ALWAYS_INLINE __forceinline
+#else
+#define JSRIBAR_SHA2_ALWAYS_INLINE inline
+#endif
+
+#if JSRIBAR_SHA2_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace jsribar::cryptography::sha2
+{
+
+struct cpu_features_t
+{
+    bool ssse3{ false };
+    bool sse41{ false };
+    bool sha{ false };
+    bool avx2{ false };
+    bool bmi2{ false };
+    bool avx512f{ false };
+};
+
+inline cpu_features_t detect_cpu_features()
+{
+    cpu_features_t features;
+
+#if JSRIBAR_SHA2_X86
+    const auto cpuid = [](uint32_t leaf, uint32_t subleaf, uint32_t (&registers)[4])
+    {
+#if defined(_MSC_VER)
+        int r[4];
+        __cpuidex(r, int(leaf), int(subleaf));
+        for (int i = 0; i < 4; ++i)
+        {
+            registers[i] = uint32_t(r[i]);
+        }
+#else
+        __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    };
+
+    // State components that operating system saves on context switch.
+    const auto xgetbv = []() -> uint64_t
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax, edx;
+        __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (uint64_t(edx) << 32) | eax;
+#endif
+    };
+
+    uint32_t registers[4]{};
+    cpuid(0, 0, registers);
+    const auto max_leaf = registers[0];
+    if (max_leaf < 1)
+    {
+        return features;
+    }
+
+    cpuid(1, 0, registers);
+    features.ssse3 = registers[2] & (1u << 9);
+    features.sse41 = registers[2] & (1u << 19);
+    const bool osxsave = registers[2] & (1u << 27);
+    const bool avx = registers[2] & (1u << 28);
+
+    const auto xcr0 = osxsave ? xgetbv() : 0;
+    const bool ymm_enabled = (xcr0 & 0x06) == 0x06;
+    const bool zmm_enabled = (xcr0 & 0xE6) == 0xE6;
+
+    if (max_leaf < 7)
+    {
+        return features;
+    }
+
+    cpuid(7, 0, registers);
+    features.sha = registers[1] & (1u << 29);
+    features.avx2 = avx && ymm_enabled && (registers[1] & (1u << 5));
+    features.bmi2 = registers[1] & (1u << 8);
+    features.avx512f = zmm_enabled && (registers[1] & (1u << 16));
+#endif
+
+    return features;
+}
+
+// Features are detected once, on the first call.
+inline const cpu_features_t& cpu_features()
+{
+    static const cpu_features_t features{ detect_cpu_features() };
+    return features;
+}
+
+}
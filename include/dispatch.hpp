@@ -0,0 +1,304 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "avx2.hpp"
+#include "cpu_features.hpp"
+#include "sha_ni.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Runtime selection of compression kernels. CPU features are detected once and on the first call each
+// sha_base_t instantiation binds the kernel to a function pointer, so that subsequent calls are made
+// through the pointer without any checks. Kernel can be forced with JSRIBAR_SHA2_KERNEL environment
+// variable (e.g. JSRIBAR_SHA2_KERNEL=portable) or force_kernel() function, e.g. for A/B performance
+// testing. If forced kernel is not supported by CPU or by the algorithm, the best available kernel is
+// used. Compile time evaluation always uses portable implementation and is not affected.
+
+namespace jsribar::cryptography::sha2
+{
+
+enum class kernel_t
+{
+    portable,
+    sha_ni,
+    avx2,
+    avx512
+};
+
+constexpr std::string_view kernel_name(kernel_t kernel)
+{
+    switch (kernel)
+    {
+    case kernel_t::sha_ni:
+        return "sha_ni";
+    case kernel_t::avx2:
+        return "avx2";
+    case kernel_t::avx512:
+        return "avx512";
+    default:
+        return "portable";
+    }
+}
+
+constexpr std::optional<kernel_t> kernel_from_name(std::string_view name)
+{
+    for (auto kernel : { kernel_t::portable, kernel_t::sha_ni, kernel_t::avx2, kernel_t::avx512 })
+    {
+        if (kernel_name(kernel) == name)
+        {
+            return kernel;
+        }
+    }
+    return std::nullopt;
+}
+
+// Returns true if CPU supports instructions used by the kernel. AVX2 kernels use BMI2, too.
+inline bool kernel_supported(kernel_t kernel)
+{
+    switch (kernel)
+    {
+    case kernel_t::sha_ni:
+        return cpu_features().sha && cpu_features().sse41;
+    case kernel_t::avx2:
+        return cpu_features().avx2 && cpu_features().bmi2;
+    case kernel_t::avx512:
+        return cpu_features().avx512f;
+    default:
+        return true;
+    }
+}
+
+namespace dispatch
+{
+
+inline std::optional<kernel_t> kernel_from_environment()
+{
+#if defined(_MSC_VER)
+#pragma warning(suppress: 4996)
+#endif
+    const char* name = std::getenv("JSRIBAR_SHA2_KERNEL");
+    return name != nullptr ? kernel_from_name(name) : std::nullopt;
+}
+
+struct forced_kernel_t
+{
+    std::mutex mutex;
+    std::optional<kernel_t> kernel{ kernel_from_environment() };
+    // Functions that reset bound kernels, so that they are selected again on the next call.
+    std::vector<void (*)()> unbind_functions;
+    // Incremented whenever the forced kernel changes, so that cached selections (see selection_t) are made again.
+    std::atomic<uint32_t> generation{ 0 };
+};
+
+inline forced_kernel_t& forced_kernel()
+{
+    static forced_kernel_t forced;
+    return forced;
+}
+
+// Selects forced kernel if it is among candidates and supported by CPU, otherwise the first supported
+// candidate. Candidates are ordered by preference.
+inline kernel_t select_kernel(std::initializer_list<kernel_t> candidates)
+{
+    auto& forced = forced_kernel();
+    std::optional<kernel_t> forced_kernel;
+    {
+        std::lock_guard lock{ forced.mutex };
+        forced_kernel = forced.kernel;
+    }
+
+    if (forced_kernel && std::find(candidates.begin(), candidates.end(), *forced_kernel) != candidates.end() && kernel_supported(*forced_kernel))
+    {
+        return *forced_kernel;
+    }
+    for (auto kernel : candidates)
+    {
+        if (kernel_supported(kernel))
+        {
+            return kernel;
+        }
+    }
+    return kernel_t::portable;
+}
+
+// Kernel selected from the candidates, cached so that frequent callers (e.g. hash_batch()) do not take the mutex.
+// Cached value is tagged with the generation of the forced kernel that it was selected for; a selection that
+// races with force_kernel() is tagged with the previous generation and is therefore made again on the next call.
+template <kernel_t... Candidates>
+class selection_t
+{
+public:
+    static kernel_t kernel()
+    {
+        const auto generation = uint64_t(forced_kernel().generation.load(std::memory_order_acquire)) + 1;
+        const auto cached = cached_m.load(std::memory_order_relaxed);
+        if (cached >> 8 == generation)
+        {
+            return kernel_t(cached & 0xff);
+        }
+        const auto kernel = select_kernel({ Candidates... });
+        cached_m.store(generation << 8 | uint64_t(kernel), std::memory_order_relaxed);
+        return kernel;
+    }
+
+private:
+    // Zero means that no kernel has been selected yet.
+    static inline std::atomic<uint64_t> cached_m{ 0 };
+};
+
+template <typename T>
+using compress_function_t = void (*)(std::array<T, 8>& h, const uint8_t* blocks, size_t count);
+
+// Compression kernels for algorithms with given round constants. Function pointer initially points to a
+// function that selects and binds the kernel and then forwards the call to it.
+template <typename RoundConstants, typename T, compress_function_t<T> portable>
+class dispatcher_t
+{
+public:
+    static void compress(std::array<T, 8>& h, const uint8_t* blocks, size_t count)
+    {
+        compress_m.load(std::memory_order_relaxed)(h, blocks, count);
+    }
+
+    static kernel_t kernel()
+    {
+        if (compress_m.load(std::memory_order_acquire) == &bind_and_compress)
+        {
+            bind();
+        }
+        return kernel_m.load(std::memory_order_relaxed);
+    }
+
+private:
+    static void bind()
+    {
+        static const bool registered = []
+        {
+            auto& forced = forced_kernel();
+            std::lock_guard lock{ forced.mutex };
+            forced.unbind_functions.push_back(&unbind);
+            return true;
+        }();
+        (void)registered;
+
+        // If force_kernel() runs while the kernel is being selected, its unbind() may precede binding of the
+        // selected function and the stale kernel would stay bound, so selection is repeated until the generation of
+        // the forced kernel does not change meanwhile.
+        auto& forced = forced_kernel();
+        auto generation = forced.generation.load();
+        while (true)
+        {
+            bind(select());
+            const auto current = forced.generation.load();
+            if (current == generation)
+            {
+                break;
+            }
+            generation = current;
+        }
+    }
+
+    static kernel_t select()
+    {
+        // SHA extensions support SHA-224/SHA-256 only.
+        return sizeof(T) == 4
+            ? select_kernel({ kernel_t::sha_ni, kernel_t::avx2, kernel_t::portable })
+            : select_kernel({ kernel_t::avx2, kernel_t::portable });
+    }
+
+    static void bind(kernel_t kernel)
+    {
+
+        compress_function_t<T> function = portable;
+#if JSRIBAR_SHA2_X86
+        if constexpr (sizeof(T) == 4)
+        {
+            if (kernel == kernel_t::sha_ni)
+            {
+                function = &sha_ni::compress<RoundConstants>;
+            }
+        }
+        if (kernel == kernel_t::avx2)
+        {
+            function = &avx2::compress<RoundConstants, T>;
+        }
+#endif
+        kernel_m.store(kernel, std::memory_order_relaxed);
+        compress_m.store(function);
+    }
+
+    static void unbind()
+    {
+        compress_m.store(&bind_and_compress, std::memory_order_release);
+    }
+
+    static void bind_and_compress(std::array<T, 8>& h, const uint8_t* blocks, size_t count)
+    {
+        bind();
+        compress(h, blocks, count);
+    }
+
+    static inline std::atomic<compress_function_t<T>> compress_m{ &bind_and_compress };
+    static inline std::atomic<kernel_t> kernel_m{ kernel_t::portable };
+};
+
+}
+
+// Forces the kernel used by all algorithms that support it. Passing std::nullopt restores automatic selection.
+// Hashing that is in progress in other threads may still complete with the previous kernel; kernels being bound
+// concurrently are selected again (see dispatcher_t::bind()).
+inline void force_kernel(std::optional<kernel_t> kernel)
+{
+    auto& forced = dispatch::forced_kernel();
+    std::vector<void (*)()> unbind_functions;
+    {
+        std::lock_guard lock{ forced.mutex };
+        forced.kernel = kernel;
+        unbind_functions = forced.unbind_functions;
+    }
+    forced.generation.fetch_add(1, std::memory_order_release);
+    for (auto unbind : unbind_functions)
+    {
+        unbind();
+    }
+}
+
+}
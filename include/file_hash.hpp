@@ -0,0 +1,765 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "sha2.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if !defined(JSRIBAR_SHA2_NO_IO_URING) && defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define JSRIBAR_SHA2_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#else
+#define JSRIBAR_SHA2_IO_URING 0
+#endif
+
+// Hashing of large files with reading overlapped with hashing. A single message cannot be hashed in parallel, but
+// the next parts of the file can be read while the current one is hashed, so that the total time approaches the
+// longer of the read and hash times instead of their sum. Several buffers are kept in flight: on Linux they are
+// read asynchronously through io_uring, otherwise (or if io_uring is not permitted, e.g. by a seccomp filter) by
+// a reader thread with pread. Define JSRIBAR_SHA2_NO_IO_URING to always use the reader thread.
+
+namespace jsribar::cryptography::sha2
+{
+
+enum class file_reader_t
+{
+    // io_uring if available, otherwise pread.
+    automatic,
+    io_uring,
+    pread,
+};
+
+struct file_hash_options_t
+{
+    file_reader_t reader{ file_reader_t::automatic };
+    // Size of each buffer, rounded up to a multiple of 4096 bytes.
+    size_t buffer_size{ size_t(1) << 20 };
+    // Number of buffers, i.e. the maximum number of reads in flight.
+    size_t buffers{ 4 };
+    // Reads bypass the page cache (O_DIRECT), if the file system supports it.
+    bool direct{ false };
+};
+
+// Time spent in each stage of hash_file(). If the hashing thread waited for reads for a significant part of the
+// total time, hashing is I/O-bound; if it hardly waited at all, it is compute-bound.
+struct file_hash_timing_t
+{
+    // Reader and mode that were actually used.
+    file_reader_t reader{ file_reader_t::automatic };
+    bool direct{ false };
+    uint64_t bytes{ 0 };
+    std::chrono::nanoseconds total{ 0 };
+    // Time the hashing thread waited for reads to complete or spent submitting them.
+    std::chrono::nanoseconds wait{ 0 };
+    std::chrono::nanoseconds hash{ 0 };
+};
+
+template <typename Sha>
+struct file_hash_result_t
+{
+    typename Sha::message_digest_t digest{};
+    std::error_code error;
+    file_hash_timing_t timing;
+};
+
+namespace file_hash_detail
+{
+
+using clock = std::chrono::steady_clock;
+
+// Alignment of buffers, offsets and read sizes required by O_DIRECT.
+constexpr size_t alignment_k{ 4096 };
+
+inline std::error_code last_error()
+{
+    return { errno, std::generic_category() };
+}
+
+struct descriptor_t
+{
+    int fd{ -1 };
+
+    descriptor_t() = default;
+
+    explicit descriptor_t(int fd)
+        : fd{ fd }
+    {
+    }
+
+    descriptor_t(const descriptor_t&) = delete;
+    descriptor_t& operator=(const descriptor_t&) = delete;
+
+    ~descriptor_t()
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+};
+
+struct aligned_delete_t
+{
+    void operator()(uint8_t* memory) const
+    {
+        ::operator delete(memory, std::align_val_t{ alignment_k });
+    }
+};
+
+using aligned_buffer_t = std::unique_ptr<uint8_t, aligned_delete_t>;
+
+inline aligned_buffer_t allocate(size_t size)
+{
+    return aligned_buffer_t{ static_cast<uint8_t*>(::operator new(size, std::align_val_t{ alignment_k })) };
+}
+
+// File is read in chunks of buffer size; chunk i is read into buffer i % buffers.
+struct layout_t
+{
+    int fd;
+    uint64_t size;
+    size_t buffer_size;
+    size_t buffers;
+    bool direct;
+
+    uint64_t chunks() const
+    {
+        return (size + buffer_size - 1) / buffer_size;
+    }
+
+    size_t chunk_size(uint64_t chunk) const
+    {
+        return size_t(std::min<uint64_t>(buffer_size, size - chunk * buffer_size));
+    }
+
+    // O_DIRECT requires the size to be aligned, so the last chunk is read into the whole buffer.
+    size_t read_size(uint64_t chunk) const
+    {
+        return direct ? buffer_size : chunk_size(chunk);
+    }
+};
+
+struct chunk_t
+{
+    const uint8_t* data{ nullptr };
+    size_t size{ 0 };
+    std::error_code error;
+};
+
+// Reads the chunks in order by a separate thread; the thread waits whenever the buffer of the next chunk has not
+// been released by the hashing thread yet.
+class pread_reader_t
+{
+public:
+    explicit pread_reader_t(const layout_t& layout)
+        : layout_m{ layout }
+        , memory_m{ allocate(layout.buffer_size * layout.buffers) }
+        , slots_m{ std::make_unique<slot_t[]>(layout.buffers) }
+        , thread_m{ [this] { run(); } }
+    {
+    }
+
+    pread_reader_t(const pread_reader_t&) = delete;
+    pread_reader_t& operator=(const pread_reader_t&) = delete;
+
+    ~pread_reader_t()
+    {
+        stopping_m.store(true);
+        for (size_t i = 0; i < layout_m.buffers; ++i)
+        {
+            slots_m[i].state.store(free_k);
+            slots_m[i].state.notify_one();
+        }
+        thread_m.join();
+    }
+
+    // Waits for the next chunk; returns an empty chunk at the end of file.
+    chunk_t next()
+    {
+        if (next_m == layout_m.chunks())
+        {
+            return {};
+        }
+        const auto index = size_t(next_m % layout_m.buffers);
+        auto& slot = slots_m[index];
+        slot.state.wait(free_k, std::memory_order_acquire);
+        if (slot.state.load(std::memory_order_acquire) == failed_k)
+        {
+            return { nullptr, 0, slot.error };
+        }
+        return { memory_m.get() + index * layout_m.buffer_size, layout_m.chunk_size(next_m), {} };
+    }
+
+    // Releases the buffer of the chunk returned by next().
+    void release()
+    {
+        auto& slot = slots_m[next_m % layout_m.buffers];
+        slot.state.store(free_k, std::memory_order_release);
+        slot.state.notify_one();
+        ++next_m;
+    }
+
+private:
+    static constexpr uint8_t free_k{ 0 };
+    static constexpr uint8_t ready_k{ 1 };
+    static constexpr uint8_t failed_k{ 2 };
+
+    struct slot_t
+    {
+        std::atomic<uint8_t> state{ free_k };
+        std::error_code error;
+    };
+
+    const layout_t layout_m;
+    aligned_buffer_t memory_m;
+    std::unique_ptr<slot_t[]> slots_m;
+    uint64_t next_m{ 0 };
+    std::atomic<bool> stopping_m{ false };
+    std::thread thread_m;
+
+    void run()
+    {
+        for (uint64_t chunk = 0; chunk < layout_m.chunks(); ++chunk)
+        {
+            const auto index = size_t(chunk % layout_m.buffers);
+            auto& slot = slots_m[index];
+            slot.state.wait(ready_k, std::memory_order_acquire);
+            if (stopping_m.load())
+            {
+                return;
+            }
+            slot.error = read(memory_m.get() + index * layout_m.buffer_size, chunk);
+            slot.state.store(slot.error ? failed_k : ready_k, std::memory_order_release);
+            slot.state.notify_one();
+            if (slot.error)
+            {
+                return;
+            }
+        }
+    }
+
+    std::error_code read(uint8_t* buffer, uint64_t chunk) const
+    {
+        const auto offset = chunk * layout_m.buffer_size;
+        const auto size = layout_m.chunk_size(chunk);
+        const auto read_size = layout_m.read_size(chunk);
+        size_t done = 0;
+        while (done < size)
+        {
+            const auto result = ::pread(layout_m.fd, buffer + done, read_size - done, off_t(offset + done));
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return last_error();
+            }
+            // File has been truncated since it was opened.
+            if (result == 0)
+            {
+                return std::make_error_code(std::errc::io_error);
+            }
+            done += size_t(result);
+        }
+        return {};
+    }
+};
+
+#if JSRIBAR_SHA2_IO_URING
+
+// Minimal io_uring interface built directly on system calls, so that liburing is not required.
+class io_uring_t
+{
+public:
+    explicit io_uring_t(unsigned entries)
+    {
+        io_uring_params params{};
+        ring_fd_m.fd = int(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd_m.fd < 0)
+        {
+            error_m = last_error();
+            return;
+        }
+        sq_size_m = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_m = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap)
+        {
+            sq_size_m = cq_size_m = std::max(sq_size_m, cq_size_m);
+        }
+        sq_ring_m = map(sq_size_m, IORING_OFF_SQ_RING);
+        cq_ring_m = single_mmap ? sq_ring_m : map(cq_size_m, IORING_OFF_CQ_RING);
+        sqes_size_m = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_m = static_cast<io_uring_sqe*>(map(sqes_size_m, IORING_OFF_SQES));
+        if (sq_ring_m == nullptr || cq_ring_m == nullptr || sqes_m == nullptr)
+        {
+            error_m = last_error();
+            return;
+        }
+
+        const auto sq_ring = static_cast<uint8_t*>(sq_ring_m);
+        sq_tail_m = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.tail);
+        sq_mask_m = *reinterpret_cast<unsigned*>(sq_ring + params.sq_off.ring_mask);
+        sq_array_m = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.array);
+        const auto cq_ring = static_cast<uint8_t*>(cq_ring_m);
+        cq_head_m = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.head);
+        cq_tail_m = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.tail);
+        cq_mask_m = *reinterpret_cast<unsigned*>(cq_ring + params.cq_off.ring_mask);
+        cqes_m = reinterpret_cast<io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+    }
+
+    io_uring_t(const io_uring_t&) = delete;
+    io_uring_t& operator=(const io_uring_t&) = delete;
+
+    ~io_uring_t()
+    {
+        if (sqes_m != nullptr)
+        {
+            ::munmap(sqes_m, sqes_size_m);
+        }
+        if (cq_ring_m != nullptr && cq_ring_m != sq_ring_m)
+        {
+            ::munmap(cq_ring_m, cq_size_m);
+        }
+        if (sq_ring_m != nullptr)
+        {
+            ::munmap(sq_ring_m, sq_size_m);
+        }
+    }
+
+    std::error_code error() const
+    {
+        return error_m;
+    }
+
+    // Queues a read, which is submitted by the next enter(); the caller must not have more requests in flight
+    // (queued or submitted) than entries of the ring.
+    void push_read(int fd, const iovec* vector, uint64_t offset, uint64_t user_data)
+    {
+        const auto tail = *sq_tail_m;
+        const auto index = tail & sq_mask_m;
+        auto& sqe = sqes_m[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(vector);
+        sqe.len = 1;
+        sqe.off = offset;
+        sqe.user_data = user_data;
+        sq_array_m[index] = index;
+        std::atomic_ref{ *sq_tail_m }.store(tail + 1, std::memory_order_release);
+        ++queued_m;
+    }
+
+    // Submits queued requests and waits for the given number of completions. Requests the kernel has not consumed
+    // (e.g. on failure) remain queued and are submitted by the next call.
+    std::error_code enter(unsigned wait)
+    {
+        const unsigned flags = wait > 0 ? IORING_ENTER_GETEVENTS : 0;
+        while (true)
+        {
+            const auto submitted = ::syscall(__NR_io_uring_enter, ring_fd_m.fd, queued_m, wait, flags, nullptr, 0);
+            if (submitted >= 0)
+            {
+                queued_m -= unsigned(submitted);
+                return {};
+            }
+            if (errno != EINTR)
+            {
+                return last_error();
+            }
+        }
+    }
+
+    bool pop(uint64_t& user_data, int& result)
+    {
+        const auto head = *cq_head_m;
+        if (head == std::atomic_ref{ *cq_tail_m }.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        const auto& cqe = cqes_m[head & cq_mask_m];
+        user_data = cqe.user_data;
+        result = cqe.res;
+        std::atomic_ref{ *cq_head_m }.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    descriptor_t ring_fd_m;
+    std::error_code error_m;
+    void* sq_ring_m{ nullptr };
+    void* cq_ring_m{ nullptr };
+    io_uring_sqe* sqes_m{ nullptr };
+    size_t sq_size_m{ 0 };
+    size_t cq_size_m{ 0 };
+    size_t sqes_size_m{ 0 };
+    unsigned* sq_tail_m{ nullptr };
+    unsigned* sq_array_m{ nullptr };
+    unsigned sq_mask_m{ 0 };
+    unsigned* cq_head_m{ nullptr };
+    unsigned* cq_tail_m{ nullptr };
+    unsigned cq_mask_m{ 0 };
+    io_uring_cqe* cqes_m{ nullptr };
+    unsigned queued_m{ 0 };
+
+    void* map(size_t size, off_t offset) const
+    {
+        const auto memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_m.fd, offset);
+        return memory == MAP_FAILED ? nullptr : memory;
+    }
+};
+
+// Keeps a read of each buffer in flight; when the hashing thread releases a buffer, the read of the chunk that
+// follows the ones in flight is submitted into it. Chunks may complete in any order, but are returned in order.
+class io_uring_reader_t
+{
+public:
+    explicit io_uring_reader_t(const layout_t& layout)
+        : layout_m{ layout }
+        , ring_m{ unsigned(layout.buffers) }
+        , memory_m{ allocate(layout.buffer_size * layout.buffers) }
+        , slots_m{ std::make_unique<slot_t[]>(layout.buffers) }
+    {
+        if (ring_m.error())
+        {
+            return;
+        }
+        for (uint64_t chunk = 0; chunk < std::min<uint64_t>(layout_m.buffers, layout_m.chunks()); ++chunk)
+        {
+            submit(chunk);
+        }
+    }
+
+    io_uring_reader_t(const io_uring_reader_t&) = delete;
+    io_uring_reader_t& operator=(const io_uring_reader_t&) = delete;
+
+    // Buffers must not be freed while the kernel may still write into them.
+    ~io_uring_reader_t()
+    {
+        uint64_t user_data;
+        int result;
+        while (in_flight_m > 0)
+        {
+            if (ring_m.pop(user_data, result))
+            {
+                --in_flight_m;
+            }
+            // enter() retries interrupted waits, so an error means that completions cannot be awaited at all;
+            // buffers and the vectors describing them are then leaked rather than freed under reads in flight.
+            else if (ring_m.enter(1))
+            {
+                (void)memory_m.release();
+                (void)slots_m.release();
+                return;
+            }
+        }
+    }
+
+    // Error if io_uring is not available.
+    std::error_code error() const
+    {
+        return ring_m.error();
+    }
+
+    chunk_t next()
+    {
+        if (next_m == layout_m.chunks())
+        {
+            return {};
+        }
+        const auto index = size_t(next_m % layout_m.buffers);
+        auto& slot = slots_m[index];
+        while (slot.done < layout_m.chunk_size(next_m) && !slot.error)
+        {
+            if (!reap())
+            {
+                if (const auto error = ring_m.enter(1))
+                {
+                    return { nullptr, 0, error };
+                }
+            }
+        }
+        if (slot.error)
+        {
+            return { nullptr, 0, slot.error };
+        }
+        return { memory_m.get() + index * layout_m.buffer_size, layout_m.chunk_size(next_m), {} };
+    }
+
+    void release()
+    {
+        const auto chunk = next_m + layout_m.buffers;
+        if (chunk < layout_m.chunks())
+        {
+            submit(chunk);
+        }
+        ++next_m;
+    }
+
+private:
+    struct slot_t
+    {
+        uint64_t chunk{ 0 };
+        size_t done{ 0 };
+        std::error_code error;
+        iovec vector{};
+    };
+
+    const layout_t layout_m;
+    io_uring_t ring_m;
+    aligned_buffer_t memory_m;
+    std::unique_ptr<slot_t[]> slots_m;
+    uint64_t next_m{ 0 };
+    size_t in_flight_m{ 0 };
+
+    void submit(uint64_t chunk)
+    {
+        auto& slot = slots_m[chunk % layout_m.buffers];
+        slot.chunk = chunk;
+        slot.done = 0;
+        slot.error = {};
+        queue(slot);
+    }
+
+    // Queues the read of the remaining part of the chunk. The read is in flight as soon as it is queued: if it
+    // cannot be submitted now, the next enter() submits it or reports the error.
+    void queue(slot_t& slot)
+    {
+        const auto index = size_t(slot.chunk % layout_m.buffers);
+        slot.vector.iov_base = memory_m.get() + index * layout_m.buffer_size + slot.done;
+        slot.vector.iov_len = layout_m.read_size(slot.chunk) - slot.done;
+        ring_m.push_read(layout_m.fd, &slot.vector, slot.chunk * layout_m.buffer_size + slot.done, index);
+        ++in_flight_m;
+        ring_m.enter(0);
+    }
+
+    // Processes available completions; returns false if there were none.
+    bool reap()
+    {
+        uint64_t user_data;
+        int result;
+        bool reaped = false;
+        while (ring_m.pop(user_data, result))
+        {
+            reaped = true;
+            --in_flight_m;
+            auto& slot = slots_m[user_data];
+            if (result == -EAGAIN || result == -EINTR)
+            {
+                queue(slot);
+            }
+            else if (result < 0)
+            {
+                slot.error = std::error_code{ -result, std::generic_category() };
+            }
+            // File has been truncated since it was opened.
+            else if (result == 0)
+            {
+                slot.error = std::make_error_code(std::errc::io_error);
+            }
+            else
+            {
+                const auto start = slot.done;
+                slot.done += size_t(result);
+                if (slot.done < layout_m.chunk_size(slot.chunk))
+                {
+                    // O_DIRECT requires an aligned offset, so the rest of a short direct read is read from the
+                    // preceding aligned offset; if that is where the read started, the file has been truncated.
+                    if (layout_m.direct)
+                    {
+                        slot.done = slot.done / alignment_k * alignment_k;
+                    }
+                    if (slot.done == start)
+                    {
+                        slot.error = std::make_error_code(std::errc::io_error);
+                    }
+                    else
+                    {
+                        queue(slot);
+                    }
+                }
+            }
+        }
+        return reaped;
+    }
+};
+
+#endif
+
+template <typename Hasher, typename Reader>
+std::error_code hash_chunks(Reader& reader, Hasher& hasher, file_hash_timing_t& timing)
+{
+    auto start = clock::now();
+    while (true)
+    {
+        const auto chunk = reader.next();
+        const auto read = clock::now();
+        timing.wait += read - start;
+        if (chunk.error || chunk.size == 0)
+        {
+            return chunk.error;
+        }
+        hasher.update(reinterpret_cast<const char*>(chunk.data), chunk.size);
+        start = clock::now();
+        timing.hash += start - read;
+        timing.bytes += chunk.size;
+        // Buffered reads from the page cache may be completed already on submission, so releasing the buffer
+        // counts as waiting for reads.
+        reader.release();
+    }
+}
+
+inline int open_file(const char* path, bool direct, bool& direct_used)
+{
+    direct_used = false;
+#if defined(O_DIRECT)
+    if (direct)
+    {
+        const auto fd = ::open(path, O_RDONLY | O_CLOEXEC | O_DIRECT);
+        // File systems that do not support O_DIRECT (e.g. tmpfs) fail with EINVAL; the page cache is used then.
+        if (fd >= 0 || errno != EINVAL)
+        {
+            direct_used = fd >= 0;
+            return fd;
+        }
+    }
+#endif
+    return ::open(path, O_RDONLY | O_CLOEXEC);
+}
+
+}
+
+// Returns true if io_uring can be used, i.e. it is supported by the kernel and permitted for the process.
+inline bool io_uring_available()
+{
+#if JSRIBAR_SHA2_IO_URING
+    static const bool available = !file_hash_detail::io_uring_t{ 1 }.error();
+    return available;
+#else
+    return false;
+#endif
+}
+
+// Appends the content of a regular file to the hasher, reading it in parallel with hashing. The hasher can be
+// any type with update(const char*, size_t) member, e.g. a hasher continuing from a prefix. The file is appended
+// up to its size at the time it was opened; if it is truncated meanwhile, an I/O error is reported. Times of the
+// stages are added to the timing.
+template <typename Hasher>
+std::error_code update_from_file(Hasher& hasher, const char* path, file_hash_timing_t& timing, const file_hash_options_t& options = {})
+{
+    using namespace file_hash_detail;
+
+    const auto start = clock::now();
+    std::error_code error;
+    const descriptor_t file{ open_file(path, options.direct, timing.direct) };
+    struct stat status;
+    if (file.fd < 0 || ::fstat(file.fd, &status) != 0)
+    {
+        return last_error();
+    }
+    if (!S_ISREG(status.st_mode))
+    {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (!timing.direct)
+    {
+        ::posix_fadvise(file.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+
+    const auto buffer_size = (std::max<size_t>(options.buffer_size, 1) + alignment_k - 1) / alignment_k * alignment_k;
+    const layout_t layout{ file.fd, uint64_t(status.st_size), buffer_size, std::max<size_t>(options.buffers, 1), timing.direct };
+    bool hashed = false;
+#if JSRIBAR_SHA2_IO_URING
+    if (options.reader != file_reader_t::pread)
+    {
+        io_uring_reader_t reader{ layout };
+        if (!reader.error())
+        {
+            timing.reader = file_reader_t::io_uring;
+            error = hash_chunks(reader, hasher, timing);
+            hashed = true;
+        }
+        else if (options.reader == file_reader_t::io_uring)
+        {
+            return reader.error();
+        }
+    }
+#else
+    if (options.reader == file_reader_t::io_uring)
+    {
+        return std::make_error_code(std::errc::function_not_supported);
+    }
+#endif
+    if (!hashed)
+    {
+        pread_reader_t reader{ layout };
+        timing.reader = file_reader_t::pread;
+        error = hash_chunks(reader, hasher, timing);
+    }
+    timing.total += clock::now() - start;
+    return error;
+}
+
+// Evaluates the digest of a regular file, reading it in parallel with hashing (see update_from_file()).
+template <typename Sha>
+file_hash_result_t<Sha> hash_file(const char* path, const file_hash_options_t& options = {})
+{
+    file_hash_result_t<Sha> result;
+    Sha hasher;
+    result.error = update_from_file(hasher, path, result.timing, options);
+    if (!result.error)
+    {
+        result.digest = hasher.finalize();
+    }
+    return result;
+}
+
+}
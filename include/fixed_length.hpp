@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "sha2.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// Hashing of messages whose length is known at compile time, e.g. nodes of Merkle trees (two concatenated
+// digests) or links of hash chains (a single digest). Since the length is fixed, padding and message length are
+// known in advance: the tail of the message is copied over a constant template of the padded last block(s),
+// without the buffering and padding steps of the hasher. If the message length is a multiple of the message
+// block size, the last block consists of padding only and its message schedule is evaluated at compile time.
+
+namespace jsribar::cryptography::sha2
+{
+
+namespace fixed_length_detail
+{
+
+// Padded tail of a message of N bytes, with bytes of the message left zero. Tail takes one block, or two if
+// the padding bit and the message length do not fit after the incomplete block of the message.
+template <typename Sha, size_t N>
+constexpr auto padding_template()
+{
+    constexpr size_t block_size = Sha::message_block_size_k;
+    constexpr size_t length_size = sizeof(typename Sha::word_t) * 2;
+    constexpr size_t remainder = N % block_size;
+
+    std::array<uint8_t, remainder + 1 + length_size <= block_size ? block_size : 2 * block_size> tail{};
+    tail[remainder] = 0x80;
+    to_uint8_array(uint64_t(N) * 8, tail.data() + tail.size() - sizeof(uint64_t));
+    return tail;
+}
+
+template <typename Sha, size_t N>
+constexpr auto padding_k{ padding_template<Sha, N>() };
+
+// Message schedule of the block that consists of padding only.
+template <typename Sha, size_t N>
+constexpr auto padding_schedule_k{ Sha::message_schedule(padding_k<Sha, N>.data()) };
+
+}
+
+// Evaluates digest of a message of exactly N bytes.
+template <typename Sha, size_t N>
+constexpr typename Sha::message_digest_t hash_fixed(const uint8_t* message)
+{
+    using namespace fixed_length_detail;
+
+    constexpr size_t full_blocks = N / Sha::message_block_size_k;
+    constexpr size_t remainder = N % Sha::message_block_size_k;
+
+    std::array<typename Sha::word_t, 8> state{ typename Sha::initial_hash_values_t{}.values };
+    if constexpr (full_blocks > 0)
+    {
+        Sha::compress_blocks(state, message, full_blocks);
+    }
+    if constexpr (remainder == 0)
+    {
+        Sha::compress_scheduled(state, padding_schedule_k<Sha, N>);
+    }
+    else
+    {
+        auto tail{ padding_k<Sha, N> };
+        std::copy_n(message + full_blocks * Sha::message_block_size_k, remainder, tail.begin());
+        Sha::compress_blocks(state, tail.data(), tail.size() / Sha::message_block_size_k);
+    }
+    return Sha::to_digest(state);
+}
+
+template <typename Sha, size_t N>
+constexpr typename Sha::message_digest_t hash_fixed(const std::array<uint8_t, N>& message)
+{
+    return hash_fixed<Sha, N>(message.data());
+}
+
+// Double SHA-256, i.e. SHA-256 of SHA-256 digest, as used by Bitcoin. Outer hash is evaluated by the fixed
+// length hasher.
+constexpr sha256_t::message_digest_t sha256d(std::string_view input)
+{
+    return hash_fixed<sha256_t>(sha256(input));
+}
+
+template <size_t N>
+constexpr sha256_t::message_digest_t sha256d(const std::array<uint8_t, N>& message)
+{
+    return hash_fixed<sha256_t>(hash_fixed<sha256_t>(message));
+}
+
+}
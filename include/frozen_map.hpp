@@ -0,0 +1,368 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "sha2.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+// Lookup tables keyed by strings that are built at compile time and store only digests of the keys, so that
+// the keys themselves do not appear in the executable (provided the table is a constexpr variable). Slots of
+// the keys are assigned by a perfect hash function (hash and displace): digest words select a bucket, and a
+// seed stored for the bucket selects the slot of each key in it. A lookup therefore evaluates a single digest
+// of the query, reads the seed of its bucket and compares the fingerprint in one slot.
+
+namespace jsribar::cryptography::sha2
+{
+
+namespace frozen_detail
+{
+
+// Finalizer of splitmix64, used to derive slots of keys from the digest word and the bucket seed.
+constexpr uint64_t mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111eb;
+    x ^= x >> 31;
+    return x;
+}
+
+// Leading two words of the digest: the first one selects the bucket, the second one the slot.
+struct hash_words_t
+{
+    uint64_t bucket;
+    uint64_t slot;
+
+    constexpr bool operator==(const hash_words_t&) const = default;
+};
+
+template <typename Digest>
+constexpr hash_words_t hash_words(const Digest& digest)
+{
+    return { to_uint<uint64_t>(digest.data()), to_uint<uint64_t>(digest.data() + sizeof(uint64_t)) };
+}
+
+// Perfect hash function for N keys. There are about two keys per bucket and at least as many slots as keys,
+// both powers of two. Buckets with multiple keys get a seed for which all their keys fall into free slots;
+// they are placed first, starting with the largest buckets. Keys of single-key buckets then fill the remaining
+// free slots directly, with the slot stored as a negative seed.
+template <size_t N>
+class perfect_hash_t
+{
+public:
+    static constexpr size_t bucket_count_k{ std::bit_ceil(std::max<size_t>(N / 2, 1)) };
+    static constexpr size_t slot_count_k{ std::bit_ceil(std::max<size_t>(N, 1)) };
+    // Distinct keys of a bucket are separated by one of the first few seeds; the search is bounded in case it
+    // cannot succeed, e.g. for keys with colliding leading digest words.
+    static constexpr int32_t max_seed_k{ 1 << 20 };
+
+    constexpr perfect_hash_t() = default;
+
+    // Assigns slots to all keys and returns slot of each key. Throws std::invalid_argument if keys are not distinct,
+    // which makes a constant evaluation fail at the throw.
+    constexpr std::array<size_t, N> build(const std::array<hash_words_t, N>& keys)
+    {
+        // Keys sorted by bucket (counting sort): keys of bucket b are at indices first[b] to first[b + 1].
+        std::array<size_t, bucket_count_k + 1> first{};
+        for (const auto& key : keys)
+        {
+            ++first[bucket(key) + 1];
+        }
+        for (size_t b = 0; b < bucket_count_k; ++b)
+        {
+            first[b + 1] += first[b];
+        }
+        std::array<size_t, N> order{};
+        auto next{ first };
+        for (size_t i = 0; i < N; ++i)
+        {
+            order[next[bucket(keys[i])]++] = i;
+        }
+
+        std::array<size_t, bucket_count_k> buckets{};
+        for (size_t b = 0; b < bucket_count_k; ++b)
+        {
+            buckets[b] = b;
+        }
+        std::sort(buckets.begin(), buckets.end(), [&](size_t lhs, size_t rhs)
+            {
+                const auto lhs_size = first[lhs + 1] - first[lhs];
+                const auto rhs_size = first[rhs + 1] - first[rhs];
+                return lhs_size != rhs_size ? lhs_size > rhs_size : lhs < rhs;
+            });
+
+        std::array<size_t, N> slots{};
+        std::array<bool, slot_count_k> occupied{};
+        size_t free_slot = 0;
+        for (auto b : buckets)
+        {
+            const auto begin = first[b];
+            const auto size = first[b + 1] - begin;
+            if (size == 0)
+            {
+                break;
+            }
+            if (size == 1)
+            {
+                while (occupied[free_slot])
+                {
+                    ++free_slot;
+                }
+                occupied[free_slot] = true;
+                slots[order[begin]] = free_slot;
+                seeds_m[b] = -int32_t(free_slot) - 1;
+                continue;
+            }
+
+            // Duplicate keys cannot be separated by any seed.
+            const auto bucket_keys = order.data() + begin;
+            for (size_t i = 1; i < size; ++i)
+            {
+                if (std::find_if(bucket_keys, bucket_keys + i, [&](size_t key) { return keys[key] == keys[bucket_keys[i]]; }) != bucket_keys + i)
+                {
+                    throw std::invalid_argument{ "frozen map keys are not distinct" };
+                }
+            }
+
+            for (int32_t seed = 0;; ++seed)
+            {
+                if (seed == max_seed_k)
+                {
+                    throw std::invalid_argument{ "no seed places all keys of a frozen map bucket" };
+                }
+                size_t placed = 0;
+                for (; placed < size; ++placed)
+                {
+                    const auto key = order[begin + placed];
+                    const auto slot = seeded_slot(keys[key], seed);
+                    if (occupied[slot])
+                    {
+                        break;
+                    }
+                    occupied[slot] = true;
+                    slots[key] = slot;
+                }
+                if (placed == size)
+                {
+                    seeds_m[b] = seed;
+                    break;
+                }
+                // Release slots taken by this seed and try the next one.
+                for (size_t i = 0; i < placed; ++i)
+                {
+                    occupied[slots[order[begin + i]]] = false;
+                }
+            }
+        }
+        return slots;
+    }
+
+    constexpr size_t slot(const hash_words_t& key) const
+    {
+        const auto seed = seeds_m[bucket(key)];
+        return seed < 0 ? size_t(-(seed + 1)) : seeded_slot(key, seed);
+    }
+
+private:
+    std::array<int32_t, bucket_count_k> seeds_m{};
+
+    static constexpr size_t bucket(const hash_words_t& key)
+    {
+        return size_t(key.bucket & (bucket_count_k - 1));
+    }
+
+    static constexpr size_t seeded_slot(const hash_words_t& key, int32_t seed)
+    {
+        return size_t(mix(key.slot ^ (uint64_t(seed) * 0x9e3779b97f4a7c15)) & (slot_count_k - 1));
+    }
+};
+
+struct empty_t
+{
+};
+
+}
+
+// Immutable map from strings to values that stores only fingerprints of the keys: the trailing FingerprintSize
+// bytes of their digests. With the full digest (default), a lookup of an absent key matches only if its digest
+// collides with a key. Truncated fingerprints make slots smaller (e.g. 8 bytes plus value keep four 16-byte slots
+// in a cache line) at the cost of false positives for absent keys with probability 2^(-8 * FingerprintSize).
+// Value must be default constructible; slots without keys hold zero fingerprints. Keys must be distinct: duplicate
+// keys make the constructor throw std::invalid_argument, i.e. a constexpr table fails to compile.
+template <typename Sha, typename Value, size_t N, size_t FingerprintSize = Sha::digest_size_k>
+class frozen_map_t
+{
+    static_assert(FingerprintSize > 0 && FingerprintSize <= Sha::digest_size_k);
+
+public:
+    using message_digest_t = typename Sha::message_digest_t;
+    using fingerprint_t = std::array<uint8_t, FingerprintSize>;
+
+    constexpr explicit frozen_map_t(const std::array<std::pair<std::string_view, Value>, N>& entries)
+    {
+        std::array<message_digest_t, N> digests{};
+        std::array<frozen_detail::hash_words_t, N> keys{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            digests[i] = Sha{ entries[i].first }.digest();
+            keys[i] = frozen_detail::hash_words(digests[i]);
+        }
+
+        const auto slots = index_m.build(keys);
+        for (size_t i = 0; i < N; ++i)
+        {
+            slots_m[slots[i]].fingerprint = fingerprint(digests[i]);
+            slots_m[slots[i]].value = entries[i].second;
+        }
+    }
+
+    // Returns pointer to the value of the key or nullptr if the key is not in the map.
+    constexpr const Value* find(std::string_view key) const
+    {
+        return find(Sha{ key }.digest());
+    }
+
+    // Lookup by digest of the key, e.g. if the digest is evaluated anyway.
+    constexpr const Value* find(const message_digest_t& digest) const
+    {
+        const auto& slot = slots_m[index_m.slot(frozen_detail::hash_words(digest))];
+        return std::equal(slot.fingerprint.begin(), slot.fingerprint.end(), digest.end() - FingerprintSize) ? &slot.value : nullptr;
+    }
+
+    constexpr bool contains(std::string_view key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    constexpr bool contains(const message_digest_t& digest) const
+    {
+        return find(digest) != nullptr;
+    }
+
+    static constexpr size_t size()
+    {
+        return N;
+    }
+
+private:
+    struct slot_t
+    {
+        fingerprint_t fingerprint{};
+        [[no_unique_address]] Value value{};
+    };
+
+    frozen_detail::perfect_hash_t<N> index_m;
+    alignas(64) std::array<slot_t, frozen_detail::perfect_hash_t<N>::slot_count_k> slots_m{};
+
+    static constexpr fingerprint_t fingerprint(const message_digest_t& digest)
+    {
+        fingerprint_t result{};
+        std::copy(digest.end() - FingerprintSize, digest.end(), result.begin());
+        return result;
+    }
+};
+
+// Immutable set of strings that stores only fingerprints of their digests (see frozen_map_t).
+template <typename Sha, size_t N, size_t FingerprintSize = Sha::digest_size_k>
+class frozen_set_t
+{
+public:
+    using message_digest_t = typename Sha::message_digest_t;
+
+    constexpr explicit frozen_set_t(const std::array<std::string_view, N>& keys)
+        : map_m{ to_entries(keys) }
+    {
+    }
+
+    constexpr bool contains(std::string_view key) const
+    {
+        return map_m.contains(key);
+    }
+
+    constexpr bool contains(const message_digest_t& digest) const
+    {
+        return map_m.contains(digest);
+    }
+
+    static constexpr size_t size()
+    {
+        return N;
+    }
+
+private:
+    frozen_map_t<Sha, frozen_detail::empty_t, N, FingerprintSize> map_m;
+
+    static constexpr std::array<std::pair<std::string_view, frozen_detail::empty_t>, N> to_entries(const std::array<std::string_view, N>& keys)
+    {
+        std::array<std::pair<std::string_view, frozen_detail::empty_t>, N> entries{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            entries[i].first = keys[i];
+        }
+        return entries;
+    }
+};
+
+// Builds the map from key-value pairs, e.g. make_frozen_map<sha256_t, int>({ { "key1", 1 }, { "key2", 2 } }).
+// Table should be a constexpr variable, so that the keys are hashed at compile time and not stored.
+template <typename Sha, typename Value, size_t FingerprintSize = Sha::digest_size_k, size_t N>
+constexpr frozen_map_t<Sha, Value, N, FingerprintSize> make_frozen_map(const std::pair<std::string_view, Value> (&entries)[N])
+{
+    return frozen_map_t<Sha, Value, N, FingerprintSize>{ std::to_array(entries) };
+}
+
+template <typename Sha, typename Value, size_t FingerprintSize = Sha::digest_size_k, size_t N>
+constexpr frozen_map_t<Sha, Value, N, FingerprintSize> make_frozen_map(const std::array<std::pair<std::string_view, Value>, N>& entries)
+{
+    return frozen_map_t<Sha, Value, N, FingerprintSize>{ entries };
+}
+
+template <typename Sha, size_t FingerprintSize = Sha::digest_size_k, size_t N>
+constexpr frozen_set_t<Sha, N, FingerprintSize> make_frozen_set(const std::string_view (&keys)[N])
+{
+    return frozen_set_t<Sha, N, FingerprintSize>{ std::to_array(keys) };
+}
+
+template <typename Sha, size_t FingerprintSize = Sha::digest_size_k, size_t N>
+constexpr frozen_set_t<Sha, N, FingerprintSize> make_frozen_set(const std::array<std::string_view, N>& keys)
+{
+    return frozen_set_t<Sha, N, FingerprintSize>{ keys };
+}
+
+}
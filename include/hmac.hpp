@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "multi_buffer.hpp"
+#include "sha2.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// HMAC (RFC 2104) for all SHA-2 algorithms. Key object appends inner and outer key pads to two hashers once,
+// so that for each message only the message itself and the inner digest are compressed. If key is known at
+// compile time, key object can be evaluated at compile time, too.
+
+namespace jsribar::cryptography::sha2
+{
+
+// Compares two digests in time that depends on their size only, so that comparison does not reveal how many
+// leading bytes of a forged MAC are correct.
+template <size_t N>
+constexpr bool constant_time_equal(const std::array<uint8_t, N>& lhs, const std::array<uint8_t, N>& rhs)
+{
+    uint8_t difference = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        difference |= uint8_t(lhs[i] ^ rhs[i]);
+    }
+    return difference == 0;
+}
+
+// HMAC key with inner and outer key pads precomputed. Can be reused for any number of messages.
+template <typename Sha>
+class hmac_key_t
+{
+public:
+    using message_digest_t = typename Sha::message_digest_t;
+
+    constexpr explicit hmac_key_t(std::string_view key)
+    {
+        // Keys longer than message block are replaced by their digest, shorter keys are padded with zeros.
+        std::array<char, message_block_size_k> block{};
+        if (key.size() > block.size())
+        {
+            const auto digest = Sha{ key }.digest();
+            std::transform(digest.begin(), digest.end(), block.begin(), [](uint8_t byte) { return char(byte); });
+        }
+        else
+        {
+            std::copy(key.begin(), key.end(), block.begin());
+        }
+
+        for (auto& byte : block)
+        {
+            byte = char(uint8_t(byte) ^ inner_pad_k);
+        }
+        inner_m.update(block.data(), block.size());
+
+        for (auto& byte : block)
+        {
+            byte = char(uint8_t(byte) ^ inner_pad_k ^ outer_pad_k);
+        }
+        outer_m.update(block.data(), block.size());
+    }
+
+    constexpr explicit hmac_key_t(const char* key, size_t length)
+        : hmac_key_t(std::string_view{ key, length })
+    {
+    }
+
+    // Hasher with inner key pad appended, to which the message is appended.
+    constexpr const Sha& inner() const
+    {
+        return inner_m;
+    }
+
+    // Hasher with outer key pad appended, to which the inner digest is appended.
+    constexpr const Sha& outer() const
+    {
+        return outer_m;
+    }
+
+    constexpr message_digest_t sign(std::string_view message) const
+    {
+        auto inner{ inner_m };
+        inner.update(message);
+        return outer_digest(inner.finalize());
+    }
+
+    constexpr bool verify(std::string_view message, const message_digest_t& mac) const
+    {
+        return constant_time_equal(sign(message), mac);
+    }
+
+    // Appends inner digest to the hasher with outer key pad and returns the MAC.
+    constexpr message_digest_t outer_digest(const message_digest_t& inner_digest) const
+    {
+        std::array<char, Sha::digest_size_k> bytes;
+        std::transform(inner_digest.begin(), inner_digest.end(), bytes.begin(), [](uint8_t byte) { return char(byte); });
+
+        auto outer{ outer_m };
+        outer.update(bytes.data(), bytes.size());
+        return outer.finalize();
+    }
+
+private:
+    static constexpr size_t message_block_size_k{ Sha::message_block_size_k };
+    static constexpr uint8_t inner_pad_k{ 0x36 };
+    static constexpr uint8_t outer_pad_k{ 0x5c };
+
+    Sha inner_m;
+    Sha outer_m;
+};
+
+// HMAC of a message appended in chunks. Key object must outlive it.
+template <typename Sha>
+class hmac_t
+{
+public:
+    using message_digest_t = typename Sha::message_digest_t;
+
+    constexpr explicit hmac_t(const hmac_key_t<Sha>& key)
+        : key_m{ &key }
+        , inner_m{ key.inner() }
+    {
+    }
+
+    constexpr void update(const char* input, size_t length)
+    {
+        inner_m.update(input, length);
+    }
+
+    constexpr void update(std::string_view input)
+    {
+        inner_m.update(input);
+    }
+
+    // Evaluates the MAC. Once finalized, no more data can be appended and each subsequent call returns the same MAC.
+    constexpr message_digest_t finalize()
+    {
+        if (!finalized_m)
+        {
+            mac_m = key_m->outer_digest(inner_m.finalize());
+            finalized_m = true;
+        }
+        return mac_m;
+    }
+
+private:
+    const hmac_key_t<Sha>* key_m;
+    Sha inner_m;
+    message_digest_t mac_m{};
+    bool finalized_m{ false };
+};
+
+// Evaluates MACs of independent messages. Both inner and outer hashes are evaluated in multiple SIMD lanes
+// if supported by CPU (see hash_batch()). MAC of each message is stored at the same index as the message.
+template <typename Sha>
+void sign_batch(const hmac_key_t<Sha>& key, std::span<const std::string_view> messages, std::span<typename Sha::message_digest_t> macs)
+{
+    assert(messages.size() == macs.size());
+
+    std::vector<typename Sha::message_digest_t> inner_digests(messages.size());
+    hash_batch(key.inner(), messages, std::span{ inner_digests });
+
+    std::vector<std::string_view> inner_messages;
+    inner_messages.reserve(inner_digests.size());
+    for (const auto& digest : inner_digests)
+    {
+        inner_messages.emplace_back(reinterpret_cast<const char*>(digest.data()), digest.size());
+    }
+    hash_batch(key.outer(), std::span<const std::string_view>{ inner_messages }, macs);
+}
+
+// Verifies MACs of independent messages. Result of each verification is stored at the same index as the message.
+// Returns true if all MACs are valid.
+template <typename Sha>
+bool verify_batch(const hmac_key_t<Sha>& key, std::span<const std::string_view> messages, std::span<const typename Sha::message_digest_t> macs, std::span<bool> results)
+{
+    assert(messages.size() == macs.size() && messages.size() == results.size());
+
+    std::vector<typename Sha::message_digest_t> expected(messages.size());
+    sign_batch(key, messages, std::span{ expected });
+
+    bool all_valid = true;
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+        results[i] = constant_time_equal(expected[i], macs[i]);
+        all_valid &= results[i];
+    }
+    return all_valid;
+}
+
+}
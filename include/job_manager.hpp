@@ -0,0 +1,345 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "multi_buffer.hpp"
+#include "sha2.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <semaphore>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Aggregation of hash jobs submitted by many threads into multi-buffer batches (see hash_batch()), in the style
+// of multi-buffer job managers of isa-l_crypto. A single message never fills SIMD lanes, so jobs are collected by
+// a worker thread and hashed together as soon as there are enough of them to fill the lanes, or when the oldest
+// pending job has waited for the deadline. Submission is lock-free: jobs are passed to the worker through a bounded
+// queue in which producers only claim a slot with compare-and-swap, and a producer wakes the waiting worker by
+// releasing a semaphore, which the worker acquires with the deadline as timeout.
+
+namespace jsribar::cryptography::sha2
+{
+
+namespace job_manager_detail
+{
+
+using clock = std::chrono::steady_clock;
+
+template <typename Sha>
+struct job_t
+{
+    using message_digest_t = typename Sha::message_digest_t;
+    using callback_t = std::function<void(const message_digest_t&)>;
+
+    // Empty job, e.g. a free slot of the queue.
+    job_t() = default;
+
+    // Job completed by setting the value of the promise.
+    explicit job_t(std::string_view message)
+        : message{ message }
+        , submitted{ clock::now() }
+        , promise{ std::in_place }
+    {
+    }
+
+    job_t(std::string_view message, callback_t callback)
+        : message{ message }
+        , submitted{ clock::now() }
+        , callback{ std::move(callback) }
+    {
+    }
+
+    std::string_view message;
+    clock::time_point submitted;
+    // Either callback or promise is used. Promise is created only when needed, since its shared state is allocated
+    // on construction: empty jobs and jobs with callbacks allocate nothing.
+    callback_t callback;
+    std::optional<std::promise<message_digest_t>> promise;
+
+    void complete(const message_digest_t& digest)
+    {
+        if (callback)
+        {
+            callback(digest);
+        }
+        else
+        {
+            promise->set_value(digest);
+        }
+    }
+};
+
+// Bounded multi-producer single-consumer queue (D. Vyukov's bounded queue). Each slot carries a sequence number
+// that tells whether it is free for the producer of the given position or holds a job for the consumer.
+template <typename Job>
+class job_queue_t
+{
+public:
+    explicit job_queue_t(size_t capacity)
+        : mask_m{ std::bit_ceil(std::max<size_t>(capacity, 2)) - 1 }
+        , slots_m{ std::make_unique<slot_t[]>(mask_m + 1) }
+    {
+        for (size_t i = 0; i <= mask_m; ++i)
+        {
+            slots_m[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Returns false if the queue is full.
+    bool try_push(Job& job)
+    {
+        auto position = tail_m.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& slot = slots_m[position & mask_m];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position)
+            {
+                if (tail_m.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.job = std::move(job);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (sequence < position)
+            {
+                return false;
+            }
+            else
+            {
+                position = tail_m.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Called by the single consumer only.
+    bool try_pop(Job& job)
+    {
+        auto& slot = slots_m[head_m & mask_m];
+        if (slot.sequence.load(std::memory_order_acquire) != head_m + 1)
+        {
+            return false;
+        }
+        job = std::move(slot.job);
+        slot.sequence.store(head_m + mask_m + 1, std::memory_order_release);
+        ++head_m;
+        return true;
+    }
+
+private:
+    struct slot_t
+    {
+        std::atomic<size_t> sequence;
+        Job job;
+    };
+
+    const size_t mask_m;
+    std::unique_ptr<slot_t[]> slots_m;
+    alignas(64) std::atomic<size_t> tail_m{ 0 };
+    alignas(64) size_t head_m{ 0 };
+};
+
+}
+
+// Collects hash jobs from any number of threads and hashes them in multiple SIMD lanes. Pending jobs are hashed
+// when there are at least as many of them as lanes of the multi-buffer kernel, or when the oldest one has waited
+// for the deadline. Messages must remain valid until their jobs are completed. Callbacks are invoked by the worker
+// thread, so they should be short. Jobs submitted before destruction are completed by the destructor.
+template <typename Sha>
+class hash_job_manager_t
+{
+public:
+    using message_digest_t = typename Sha::message_digest_t;
+    using callback_t = std::function<void(const message_digest_t&)>;
+
+    explicit hash_job_manager_t(std::chrono::microseconds deadline = std::chrono::microseconds{ 50 }, size_t capacity = 4096)
+        : deadline_m{ deadline }
+        , queue_m{ capacity }
+        , worker_m{ [this] { run(); } }
+    {
+    }
+
+    hash_job_manager_t(const hash_job_manager_t&) = delete;
+    hash_job_manager_t& operator=(const hash_job_manager_t&) = delete;
+
+    ~hash_job_manager_t()
+    {
+        stopping_m.store(true);
+        wake();
+        worker_m.join();
+    }
+
+    std::future<message_digest_t> submit(std::string_view message)
+    {
+        job_t job{ message };
+        auto future = job.promise->get_future();
+        push(job);
+        return future;
+    }
+
+    void submit(std::string_view message, callback_t callback)
+    {
+        job_t job{ message, std::move(callback) };
+        push(job);
+    }
+
+    std::chrono::microseconds deadline() const
+    {
+        return deadline_m;
+    }
+
+private:
+    using job_t = job_manager_detail::job_t<Sha>;
+
+    const std::chrono::microseconds deadline_m;
+    job_manager_detail::job_queue_t<job_t> queue_m;
+    // Incremented after each submission, so that the worker can wait for it to change.
+    std::atomic<uint64_t> submitted_m{ 0 };
+    // Set while the worker waits; the submitter that clears it releases the semaphore, which therefore never holds
+    // more than one token.
+    std::atomic<bool> waiting_m{ false };
+    std::counting_semaphore<> submission_m{ 0 };
+    std::atomic<bool> stopping_m{ false };
+    std::thread worker_m;
+
+    void push(job_t& job)
+    {
+        // Queue is full only if the worker falls behind; submitter then waits for it.
+        while (!queue_m.try_push(job))
+        {
+            std::this_thread::yield();
+        }
+        submitted_m.fetch_add(1);
+        notify();
+    }
+
+    void wake()
+    {
+        submitted_m.fetch_add(1);
+        notify();
+    }
+
+    void notify()
+    {
+        if (waiting_m.load() && waiting_m.exchange(false))
+        {
+            submission_m.release();
+        }
+    }
+
+    // Waits until the counter of submissions differs from seen or, unless until is nullptr, until the time point.
+    void wait(uint64_t seen, const job_manager_detail::clock::time_point* until)
+    {
+        // Submissions after the flag is set see it and release the semaphore; earlier ones have already changed the
+        // counter.
+        waiting_m.store(true);
+        if (submitted_m.load() == seen)
+        {
+            if (until == nullptr)
+            {
+                submission_m.acquire();
+                return;
+            }
+            if (submission_m.try_acquire_until(*until))
+            {
+                return;
+            }
+        }
+        // If a submitter has cleared the flag meanwhile, its token is taken so that the next wait does not return
+        // early.
+        if (!waiting_m.exchange(false))
+        {
+            submission_m.acquire();
+        }
+    }
+
+    void run()
+    {
+        std::vector<job_t> pending;
+        std::vector<std::string_view> messages;
+        std::vector<message_digest_t> digests;
+        // Number of lanes only decides when pending jobs are hashed; hash_batch() selects the kernel itself.
+        const auto lanes = batch_lanes<Sha>(batch_kernel<Sha>());
+        job_t job;
+
+        while (true)
+        {
+            const auto seen = submitted_m.load();
+            while (queue_m.try_pop(job))
+            {
+                pending.push_back(std::move(job));
+            }
+
+            if (pending.empty())
+            {
+                if (stopping_m.load())
+                {
+                    return;
+                }
+                // Submissions after the counter was read change it, so the wait returns immediately.
+                wait(seen, nullptr);
+                continue;
+            }
+
+            const auto flush = pending.front().submitted + deadline_m;
+            if (pending.size() < lanes && job_manager_detail::clock::now() < flush && !stopping_m.load())
+            {
+                wait(seen, &flush);
+                continue;
+            }
+
+            messages.clear();
+            for (const auto& pending_job : pending)
+            {
+                messages.push_back(pending_job.message);
+            }
+            digests.resize(pending.size());
+            hash_batch<Sha>(std::span<const std::string_view>{ messages }, std::span{ digests });
+            for (size_t i = 0; i < pending.size(); ++i)
+            {
+                pending[i].complete(digests[i]);
+            }
+            pending.clear();
+        }
+    }
+};
+
+}
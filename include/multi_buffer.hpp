@@ -0,0 +1,654 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "cpu_features.hpp"
+#include "sha2.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#if JSRIBAR_SHA2_X86
+#include <immintrin.h>
+#endif
+
+// Multi-buffer hashing of independent messages: each message is processed in a separate SIMD lane, so
+// that words at the same position in all lanes are transformed by a single instruction. SHA-224/SHA-256
+// use 8 lanes with AVX2 or 16 lanes with AVX-512, SHA-384/SHA-512/SHA-512/224/SHA-512/256 use 4 lanes
+// with AVX2 or 8 lanes with AVX-512. When message in a lane is completed, the lane is refilled with
+// the next message.
+
+namespace jsribar::cryptography::sha2::multi_buffer
+{
+
+#if JSRIBAR_SHA2_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+
+// Words of all lanes. GCC and Clang vector extensions are compiled for the target of the function they
+// are inlined into.
+template <typename T, size_t N>
+struct lanes_t
+{
+    typedef T vector_t __attribute__((vector_size(sizeof(T) * N), aligned(16)));
+
+    vector_t v;
+
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator+(lanes_t a, lanes_t b) { return { a.v + b.v }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator^(lanes_t a, lanes_t b) { return { a.v ^ b.v }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator&(lanes_t a, lanes_t b) { return { a.v & b.v }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator|(lanes_t a, lanes_t b) { return { a.v | b.v }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator>>(lanes_t a, int n) { return { a.v >> n }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator<<(lanes_t a, int n) { return { a.v << n }; }
+
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t load(const T* input)
+    {
+        lanes_t result;
+        std::memcpy(&result.v, input, sizeof(vector_t));
+        return result;
+    }
+
+    JSRIBAR_SHA2_ALWAYS_INLINE void store(T* output) const
+    {
+        std::memcpy(output, &v, sizeof(vector_t));
+    }
+
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t broadcast(T value)
+    {
+        lanes_t result;
+        for (size_t i = 0; i < N; ++i)
+        {
+            result.v[i] = value;
+        }
+        return result;
+    }
+};
+
+#else
+
+// Words of all lanes. MSVC has no vector extensions, so operations are mapped to intrinsics.
+template <typename T, size_t N>
+struct lanes_t;
+
+template <>
+struct lanes_t<uint32_t, 8>
+{
+    __m256i v;
+
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator+(lanes_t a, lanes_t b) { return { _mm256_add_epi32(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator^(lanes_t a, lanes_t b) { return { _mm256_xor_si256(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator&(lanes_t a, lanes_t b) { return { _mm256_and_si256(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator|(lanes_t a, lanes_t b) { return { _mm256_or_si256(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator>>(lanes_t a, int n) { return { _mm256_srli_epi32(a.v, n) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator<<(lanes_t a, int n) { return { _mm256_slli_epi32(a.v, n) }; }
+
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t load(const uint32_t* input) { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input)) }; }
+    JSRIBAR_SHA2_ALWAYS_INLINE void store(uint32_t* output) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), v); }
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t broadcast(uint32_t value) { return { _mm256_set1_epi32(int(value)) }; }
+};
+
+template <>
+struct lanes_t<uint32_t, 16>
+{
+    __m512i v;
+
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator+(lanes_t a, lanes_t b) { return { _mm512_add_epi32(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator^(lanes_t a, lanes_t b) { return { _mm512_xor_si512(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator&(lanes_t a, lanes_t b) { return { _mm512_and_si512(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator|(lanes_t a, lanes_t b) { return { _mm512_or_si512(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator>>(lanes_t a, int n) { return { _mm512_srli_epi32(a.v, n) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator<<(lanes_t a, int n) { return { _mm512_slli_epi32(a.v, n) }; }
+
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t load(const uint32_t* input) { return { _mm512_loadu_si512(input) }; }
+    JSRIBAR_SHA2_ALWAYS_INLINE void store(uint32_t* output) const { _mm512_storeu_si512(output, v); }
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t broadcast(uint32_t value) { return { _mm512_set1_epi32(int(value)) }; }
+};
+
+template <>
+struct lanes_t<uint64_t, 4>
+{
+    __m256i v;
+
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator+(lanes_t a, lanes_t b) { return { _mm256_add_epi64(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator^(lanes_t a, lanes_t b) { return { _mm256_xor_si256(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator&(lanes_t a, lanes_t b) { return { _mm256_and_si256(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator|(lanes_t a, lanes_t b) { return { _mm256_or_si256(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator>>(lanes_t a, int n) { return { _mm256_srli_epi64(a.v, n) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator<<(lanes_t a, int n) { return { _mm256_slli_epi64(a.v, n) }; }
+
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t load(const uint64_t* input) { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input)) }; }
+    JSRIBAR_SHA2_ALWAYS_INLINE void store(uint64_t* output) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), v); }
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t broadcast(uint64_t value) { return { _mm256_set1_epi64x(int64_t(value)) }; }
+};
+
+template <>
+struct lanes_t<uint64_t, 8>
+{
+    __m512i v;
+
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator+(lanes_t a, lanes_t b) { return { _mm512_add_epi64(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator^(lanes_t a, lanes_t b) { return { _mm512_xor_si512(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator&(lanes_t a, lanes_t b) { return { _mm512_and_si512(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator|(lanes_t a, lanes_t b) { return { _mm512_or_si512(a.v, b.v) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator>>(lanes_t a, int n) { return { _mm512_srli_epi64(a.v, n) }; }
+    friend JSRIBAR_SHA2_ALWAYS_INLINE lanes_t operator<<(lanes_t a, int n) { return { _mm512_slli_epi64(a.v, n) }; }
+
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t load(const uint64_t* input) { return { _mm512_loadu_si512(input) }; }
+    JSRIBAR_SHA2_ALWAYS_INLINE void store(uint64_t* output) const { _mm512_storeu_si512(output, v); }
+    static JSRIBAR_SHA2_ALWAYS_INLINE lanes_t broadcast(uint64_t value) { return { _mm512_set1_epi64(int64_t(value)) }; }
+};
+
+#endif
+
+// Sum and sigma functions evaluated for all lanes at once.
+template <typename T, typename V>
+JSRIBAR_SHA2_ALWAYS_INLINE V right_rotate_lanes(V value, int n)
+{
+    return (value >> n) | (value << (int(sizeof(T)) * 8 - n));
+}
+
+template <typename T, typename V>
+JSRIBAR_SHA2_ALWAYS_INLINE V sum0(V w)
+{
+    if constexpr (std::is_same_v<T, uint32_t>)
+    {
+        return right_rotate_lanes<T>(w, 7) ^ right_rotate_lanes<T>(w, 18) ^ (w >> 3);
+    }
+    else
+    {
+        return right_rotate_lanes<T>(w, 1) ^ right_rotate_lanes<T>(w, 8) ^ (w >> 7);
+    }
+}
+
+template <typename T, typename V>
+JSRIBAR_SHA2_ALWAYS_INLINE V sum1(V w)
+{
+    if constexpr (std::is_same_v<T, uint32_t>)
+    {
+        return right_rotate_lanes<T>(w, 17) ^ right_rotate_lanes<T>(w, 19) ^ (w >> 10);
+    }
+    else
+    {
+        return right_rotate_lanes<T>(w, 19) ^ right_rotate_lanes<T>(w, 61) ^ (w >> 6);
+    }
+}
+
+template <typename T, typename V>
+JSRIBAR_SHA2_ALWAYS_INLINE V sigma0(V h)
+{
+    if constexpr (std::is_same_v<T, uint32_t>)
+    {
+        return right_rotate_lanes<T>(h, 2) ^ right_rotate_lanes<T>(h, 13) ^ right_rotate_lanes<T>(h, 22);
+    }
+    else
+    {
+        return right_rotate_lanes<T>(h, 28) ^ right_rotate_lanes<T>(h, 34) ^ right_rotate_lanes<T>(h, 39);
+    }
+}
+
+template <typename T, typename V>
+JSRIBAR_SHA2_ALWAYS_INLINE V sigma1(V h)
+{
+    if constexpr (std::is_same_v<T, uint32_t>)
+    {
+        return right_rotate_lanes<T>(h, 6) ^ right_rotate_lanes<T>(h, 11) ^ right_rotate_lanes<T>(h, 25);
+    }
+    else
+    {
+        return right_rotate_lanes<T>(h, 14) ^ right_rotate_lanes<T>(h, 18) ^ right_rotate_lanes<T>(h, 41);
+    }
+}
+
+// Words of the hash state and of the message block, transposed so that each row holds the same word of all lanes.
+template <typename Sha, size_t N>
+using lanes_state_t = std::array<std::array<typename Sha::word_t, N>, 8>;
+
+template <typename Sha, size_t N>
+using lanes_block_t = std::array<std::array<typename Sha::word_t, N>, 16>;
+
+template <typename T, typename V>
+JSRIBAR_SHA2_ALWAYS_INLINE void round(V a, V b, V c, V& d, V e, V f, V g, V& h, V wk)
+{
+    const auto choice = g ^ (e & (f ^ g));
+    const auto temp1 = h + sigma1<T>(e) + choice + wk;
+    const auto majority = (a & b) | (c & (a | b));
+    const auto temp2 = sigma0<T>(a) + majority;
+
+    d = d + temp1;
+    h = temp1 + temp2;
+}
+
+// Returns message schedule word w[i] with round constant added, evaluating it from the preceding 16 words if needed.
+template <typename T, size_t i, typename V, typename RoundConstants>
+JSRIBAR_SHA2_ALWAYS_INLINE V schedule(std::array<V, 16>& w, const RoundConstants& k)
+{
+    if constexpr (i >= 16)
+    {
+        w[i % 16] = w[i % 16] + sum0<T>(w[(i + 1) % 16]) + w[(i + 9) % 16] + sum1<T>(w[(i + 14) % 16]);
+    }
+    return w[i % 16] + V::broadcast(k[i]);
+}
+
+// Executes rounds i..i+7 and recursively all the remaining rounds, so that all indices are compile time constants.
+// Instead of shifting working variables after each round, roles of variables are rotated.
+template <typename T, size_t i, typename V, typename RoundConstants>
+JSRIBAR_SHA2_ALWAYS_INLINE void rounds(V& a, V& b, V& c, V& d, V& e, V& f, V& g, V& h, std::array<V, 16>& w, const RoundConstants& k)
+{
+    round<T>(a, b, c, d, e, f, g, h, schedule<T, i>(w, k));
+    round<T>(h, a, b, c, d, e, f, g, schedule<T, i + 1>(w, k));
+    round<T>(g, h, a, b, c, d, e, f, schedule<T, i + 2>(w, k));
+    round<T>(f, g, h, a, b, c, d, e, schedule<T, i + 3>(w, k));
+    round<T>(e, f, g, h, a, b, c, d, schedule<T, i + 4>(w, k));
+    round<T>(d, e, f, g, h, a, b, c, schedule<T, i + 5>(w, k));
+    round<T>(c, d, e, f, g, h, a, b, schedule<T, i + 6>(w, k));
+    round<T>(b, c, d, e, f, g, h, a, schedule<T, i + 7>(w, k));
+
+    if constexpr (i + 8 < RoundConstants{}.size())
+    {
+        rounds<T, i + 8>(a, b, c, d, e, f, g, h, w, k);
+    }
+}
+
+// Compresses one message block in each lane.
+template <typename V, typename Sha, size_t N>
+JSRIBAR_SHA2_ALWAYS_INLINE void compress(lanes_state_t<Sha, N>& state, const lanes_block_t<Sha, N>& block)
+{
+    using T = typename Sha::word_t;
+    static constexpr typename Sha::round_constants_t k{};
+
+    std::array<V, 16> w;
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        w[i] = V::load(block[i].data());
+    }
+
+    auto a = V::load(state[0].data());
+    auto b = V::load(state[1].data());
+    auto c = V::load(state[2].data());
+    auto d = V::load(state[3].data());
+    auto e = V::load(state[4].data());
+    auto f = V::load(state[5].data());
+    auto g = V::load(state[6].data());
+    auto h = V::load(state[7].data());
+
+    rounds<T, 0>(a, b, c, d, e, f, g, h, w, k);
+
+    (V::load(state[0].data()) + a).store(state[0].data());
+    (V::load(state[1].data()) + b).store(state[1].data());
+    (V::load(state[2].data()) + c).store(state[2].data());
+    (V::load(state[3].data()) + d).store(state[3].data());
+    (V::load(state[4].data()) + e).store(state[4].data());
+    (V::load(state[5].data()) + f).store(state[5].data());
+    (V::load(state[6].data()) + g).store(state[6].data());
+    (V::load(state[7].data()) + h).store(state[7].data());
+}
+
+// Transposes 8 rows of 8 32-bit words, so that row i holds word i of all input rows.
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE void transpose(__m256i (&r)[8])
+{
+    const auto t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    const auto t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    const auto t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    const auto t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    const auto t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    const auto t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    const auto t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    const auto t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+    const auto u0 = _mm256_unpacklo_epi64(t0, t2);
+    const auto u1 = _mm256_unpackhi_epi64(t0, t2);
+    const auto u2 = _mm256_unpacklo_epi64(t1, t3);
+    const auto u3 = _mm256_unpackhi_epi64(t1, t3);
+    const auto u4 = _mm256_unpacklo_epi64(t4, t6);
+    const auto u5 = _mm256_unpackhi_epi64(t4, t6);
+    const auto u6 = _mm256_unpacklo_epi64(t5, t7);
+    const auto u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// Transposes 4 rows of 4 64-bit words.
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE void transpose(__m256i (&r)[4])
+{
+    const auto t0 = _mm256_unpacklo_epi64(r[0], r[1]);
+    const auto t1 = _mm256_unpackhi_epi64(r[0], r[1]);
+    const auto t2 = _mm256_unpacklo_epi64(r[2], r[3]);
+    const auto t3 = _mm256_unpackhi_epi64(r[2], r[3]);
+
+    r[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    r[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    r[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    r[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+// Loads the current message block of all lanes into rows of words. Each group of lanes that fits a 256-bit vector
+// is loaded with vector loads, converted from big endian by a byte shuffle and transposed in registers; AVX-512
+// lanes are loaded as two or four such groups.
+template <typename Sha, size_t N>
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE void load_block(const std::array<const uint8_t*, N>& blocks, lanes_block_t<Sha, N>& block)
+{
+    using T = typename Sha::word_t;
+    constexpr size_t group = 32 / sizeof(T);
+    const auto byte_order = sizeof(T) == 4
+        ? _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+        : _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+    for (size_t lane = 0; lane < N; lane += group)
+    {
+        for (size_t first = 0; first < block.size(); first += group)
+        {
+            __m256i rows[group];
+            for (size_t i = 0; i < group; ++i)
+            {
+                const auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks[lane + i] + first * sizeof(T)));
+                rows[i] = _mm256_shuffle_epi8(input, byte_order);
+            }
+            transpose(rows);
+            for (size_t i = 0; i < group; ++i)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(block[first + i].data() + lane), rows[i]);
+            }
+        }
+    }
+}
+
+// Inverse of load_block() for the hash state: stores hash values of each lane as big endian bytes.
+template <typename Sha, size_t N>
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE void store_state(const lanes_state_t<Sha, N>& state, std::array<std::array<uint8_t, 8 * sizeof(typename Sha::word_t)>, N>& words)
+{
+    using T = typename Sha::word_t;
+    constexpr size_t group = 32 / sizeof(T);
+    const auto byte_order = sizeof(T) == 4
+        ? _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+        : _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+    for (size_t lane = 0; lane < N; lane += group)
+    {
+        for (size_t first = 0; first < state.size(); first += group)
+        {
+            __m256i rows[group];
+            for (size_t i = 0; i < group; ++i)
+            {
+                rows[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[first + i].data() + lane));
+            }
+            transpose(rows);
+            for (size_t i = 0; i < group; ++i)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(words[lane + i].data() + first * sizeof(T)), _mm256_shuffle_epi8(rows[i], byte_order));
+            }
+        }
+    }
+}
+
+#endif
+
+// Message assigned to a lane. Full message blocks are read directly from the message, while the
+// remainder of the message is copied together with the padding into one or two trailing blocks.
+// Message may continue a prefix that has already been compressed, in which case the prefix length
+// is included in the length appended.
+template <typename Sha>
+class lane_t
+{
+public:
+    static constexpr size_t message_block_size_k{ Sha::message_block_size_k };
+
+    void assign(std::string_view message, size_t index, uint64_t prefix_length)
+    {
+        using T = typename Sha::word_t;
+
+        index_m = index;
+        message_m = reinterpret_cast<const uint8_t*>(message.data());
+        full_blocks_m = message.size() / message_block_size_k;
+
+        const auto remainder = message.size() % message_block_size_k;
+        std::copy_n(message_m + full_blocks_m * message_block_size_k, remainder, tail_m.data());
+        tail_m[remainder] = 0x80;
+        tail_blocks_m = remainder + 1 + 2 * sizeof(T) > message_block_size_k ? 2 : 1;
+        const auto length_offset = tail_blocks_m * message_block_size_k - 2 * sizeof(T);
+        // Message length in bits is stored as 64-bit value into the last 8 bytes of the block.
+        std::memset(tail_m.data() + remainder + 1, 0, length_offset + 2 * sizeof(T) - 8 - remainder - 1);
+        store_big_endian((prefix_length + message.size()) * 8, tail_m.data() + tail_blocks_m * message_block_size_k - 8);
+        tail_offset_m = 0;
+    }
+
+    bool blocks_left() const
+    {
+        return full_blocks_m > 0 || tail_offset_m < tail_blocks_m * message_block_size_k;
+    }
+
+    const uint8_t* next_block()
+    {
+        assert(blocks_left());
+
+        if (full_blocks_m > 0)
+        {
+            const auto block = message_m;
+            message_m += message_block_size_k;
+            --full_blocks_m;
+            return block;
+        }
+        const auto block = tail_m.data() + tail_offset_m;
+        tail_offset_m += message_block_size_k;
+        return block;
+    }
+
+    size_t index() const
+    {
+        return index_m;
+    }
+
+private:
+    size_t index_m{ 0 };
+
+    const uint8_t* message_m{ nullptr };
+    size_t full_blocks_m{ 0 };
+
+    std::array<uint8_t, 2 * message_block_size_k> tail_m;
+    size_t tail_blocks_m{ 0 };
+    size_t tail_offset_m{ 0 };
+};
+
+#if JSRIBAR_SHA2_X86
+
+// Hashes messages in N lanes of type V, refilling each lane with the next message as soon as its message is completed.
+// Each lane starts from the state of the initial hasher, which must not have any data buffered.
+template <typename V, typename Sha, size_t N>
+JSRIBAR_SHA2_TARGET("avx2") JSRIBAR_SHA2_ALWAYS_INLINE void hash_lanes(const Sha& initial, std::span<const std::string_view> messages, std::span<typename Sha::message_digest_t> digests)
+{
+    using T = typename Sha::word_t;
+    static constexpr std::array<uint8_t, Sha::message_block_size_k> idle_block{};
+
+    alignas(64) lanes_state_t<Sha, N> state;
+    alignas(64) lanes_block_t<Sha, N> block;
+    std::array<std::array<uint8_t, 8 * sizeof(T)>, N> words;
+    std::array<lane_t<Sha>, N> lanes;
+    std::array<bool, N> active{};
+    std::array<const uint8_t*, N> blocks;
+
+    size_t next_message = 0;
+    while (true)
+    {
+        size_t active_lanes = 0;
+        for (size_t lane = 0; lane < N; ++lane)
+        {
+            if (!active[lane] && next_message < messages.size())
+            {
+                lanes[lane].assign(messages[next_message], next_message, initial.message_length());
+                ++next_message;
+                for (size_t i = 0; i < state.size(); ++i)
+                {
+                    state[i][lane] = initial.hash_values()[i];
+                }
+                active[lane] = true;
+            }
+            blocks[lane] = active[lane] ? lanes[lane].next_block() : idle_block.data();
+            active_lanes += active[lane];
+        }
+
+        if (active_lanes == 0)
+        {
+            break;
+        }
+
+        load_block<Sha, N>(blocks, block);
+        compress<V, Sha, N>(state, block);
+
+        bool completed = false;
+        for (size_t lane = 0; lane < N; ++lane)
+        {
+            completed |= active[lane] && !lanes[lane].blocks_left();
+        }
+        if (!completed)
+        {
+            continue;
+        }
+        store_state<Sha, N>(state, words);
+        for (size_t lane = 0; lane < N; ++lane)
+        {
+            if (active[lane] && !lanes[lane].blocks_left())
+            {
+                // If digest is smaller than state, the rightmost surplus bytes are trimmed.
+                auto& digest = digests[lanes[lane].index()];
+                std::copy_n(words[lane].begin(), digest.size(), digest.begin());
+                active[lane] = false;
+            }
+        }
+    }
+}
+
+template <typename Sha>
+JSRIBAR_SHA2_TARGET("avx2") void hash_avx2(const Sha& initial, std::span<const std::string_view> messages, std::span<typename Sha::message_digest_t> digests)
+{
+    using T = typename Sha::word_t;
+    constexpr size_t lanes = 32 / sizeof(T);
+    hash_lanes<lanes_t<T, lanes>, Sha, lanes>(initial, messages, digests);
+}
+
+template <typename Sha>
+JSRIBAR_SHA2_TARGET("avx2,avx512f") void hash_avx512(const Sha& initial, std::span<const std::string_view> messages, std::span<typename Sha::message_digest_t> digests)
+{
+    using T = typename Sha::word_t;
+    constexpr size_t lanes = 64 / sizeof(T);
+    hash_lanes<lanes_t<T, lanes>, Sha, lanes>(initial, messages, digests);
+}
+
+#endif
+
+}
+
+namespace jsribar::cryptography::sha2
+{
+
+// Kernel used by hash_batch(). SHA extensions hash SHA-224 and SHA-256 messages one by one faster than AVX2
+// lanes hash eight of them, so they are preferred unless AVX-512 lanes are available. If no multi-buffer kernel
+// is available or a single-stream kernel is forced, messages are hashed one by one.
+template <typename Sha>
+kernel_t batch_kernel()
+{
+    if constexpr (sizeof(typename Sha::word_t) == 4)
+    {
+        return dispatch::selection_t<kernel_t::avx512, kernel_t::sha_ni, kernel_t::avx2, kernel_t::portable>::kernel();
+    }
+    else
+    {
+        return dispatch::selection_t<kernel_t::avx512, kernel_t::avx2, kernel_t::portable>::kernel();
+    }
+}
+
+// Number of messages hashed at once by hash_batch() with the given kernel.
+template <typename Sha>
+constexpr size_t batch_lanes(kernel_t kernel)
+{
+    switch (kernel)
+    {
+    case kernel_t::avx512:
+        return 64 / sizeof(typename Sha::word_t);
+    case kernel_t::avx2:
+        return 32 / sizeof(typename Sha::word_t);
+    default:
+        return 1;
+    }
+}
+
+// Evaluates digests of independent messages that all continue the message appended to the initial hasher
+// (e.g. a common prefix or HMAC key pad), in multiple SIMD lanes if supported by CPU. Digest of each message
+// is stored at the same index as the message. Lanes start from the hash values of the initial hasher, so
+// they can be used only if the length of message appended to it is a multiple of message block size.
+template <typename Sha>
+void hash_batch(const Sha& initial, std::span<const std::string_view> messages, std::span<typename Sha::message_digest_t> digests)
+{
+    assert(messages.size() == digests.size());
+
+#if JSRIBAR_SHA2_X86
+    if (initial.message_length() % Sha::message_block_size_k == 0)
+    {
+        switch (batch_kernel<Sha>())
+        {
+        case kernel_t::avx512:
+            multi_buffer::hash_avx512<Sha>(initial, messages, digests);
+            return;
+        case kernel_t::avx2:
+            multi_buffer::hash_avx2<Sha>(initial, messages, digests);
+            return;
+        default:
+            break;
+        }
+    }
+#endif
+
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+        auto sh{ initial };
+        sh.update(messages[i]);
+        digests[i] = sh.finalize();
+    }
+}
+
+// Evaluates digests of independent messages, in multiple SIMD lanes if supported by CPU. Digest of each
+// message is stored at the same index as the message.
+template <typename Sha>
+void hash_batch(std::span<const std::string_view> messages, std::span<typename Sha::message_digest_t> digests)
+{
+    hash_batch(Sha{}, messages, digests);
+}
+
+}
@@ -0,0 +1,339 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "cpu_features.hpp"
+#include "hmac.hpp"
+#include "multi_buffer.hpp"
+#include "sha2.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// PBKDF2 (RFC 8018) with HMAC based on SHA-2 algorithms. Each output block of the derived key is the XOR of
+// U1 = HMAC(password, salt || block index) and Uj = HMAC(password, Uj-1) for j = 2..iterations. Since the key
+// pads are compressed once per password (see hmac.hpp) and a digest fits into a single message block together
+// with the padding, each iteration takes exactly two compressions of fixed-layout blocks: only the digest
+// words in those blocks change, while padding and message length stay the same.
+
+namespace jsribar::cryptography::sha2::pbkdf2_detail
+{
+
+// Derivation of a single output block: hash values after key pads are compressed, current U and their XOR.
+template <typename Sha>
+struct unit_t
+{
+    using T = typename Sha::word_t;
+
+    std::array<T, 8> inner;
+    std::array<T, 8> outer;
+    std::array<T, 8> u;
+    std::array<T, 8> t;
+};
+
+template <typename Sha>
+constexpr size_t digest_words_k{ (Sha::digest_size_k + sizeof(typename Sha::word_t) - 1) / sizeof(typename Sha::word_t) };
+
+// Words of the message block that contains a digest following the key pad block. Digest words are left zero,
+// except for the last word if the digest size is not a multiple of word size (SHA-512/224), which contains
+// the padding bit, too.
+template <typename Sha>
+constexpr std::array<typename Sha::word_t, 16> digest_block_template()
+{
+    using T = typename Sha::word_t;
+    constexpr size_t full_words = Sha::digest_size_k / sizeof(T);
+    constexpr size_t remainder = Sha::digest_size_k % sizeof(T);
+
+    std::array<T, 16> words{};
+    words[full_words] = T(0x80) << (8 * (sizeof(T) - remainder - 1));
+    words[15] = T((Sha::message_block_size_k + Sha::digest_size_k) * 8);
+    return words;
+}
+
+// Mask of digest bytes in the last digest word.
+template <typename Sha>
+constexpr typename Sha::word_t last_word_mask()
+{
+    using T = typename Sha::word_t;
+    constexpr size_t remainder = Sha::digest_size_k % sizeof(T);
+    return remainder == 0 ? T(~T(0)) : T(~(T(~T(0)) >> (8 * remainder)));
+}
+
+// Evaluates U1 and initializes the unit for the given output block (1-based index).
+template <typename Sha>
+unit_t<Sha> make_unit(const hmac_key_t<Sha>& key, std::string_view salt, uint32_t index)
+{
+    std::array<uint8_t, 4> index_bytes;
+    store_big_endian(index, index_bytes.data());
+
+    auto inner{ key.inner() };
+    inner.update(salt);
+    inner.update(reinterpret_cast<const char*>(index_bytes.data()), index_bytes.size());
+    const auto inner_digest = inner.finalize();
+
+    auto outer{ key.outer() };
+    outer.update(reinterpret_cast<const char*>(inner_digest.data()), inner_digest.size());
+    outer.finalize();
+
+    unit_t<Sha> unit{ key.inner().hash_values(), key.outer().hash_values(), outer.hash_values(), outer.hash_values() };
+    return unit;
+}
+
+// Writes the output block, truncated to the digest size and to the size of destination.
+template <typename Sha>
+void store_unit(const unit_t<Sha>& unit, std::span<uint8_t> destination)
+{
+    using T = typename Sha::word_t;
+
+    std::array<uint8_t, 8 * sizeof(T)> bytes;
+    for (size_t i = 0; i < unit.t.size(); ++i)
+    {
+        store_big_endian(unit.t[i], bytes.data() + i * sizeof(T));
+    }
+    std::copy_n(bytes.begin(), std::min(destination.size(), Sha::digest_size_k), destination.begin());
+}
+
+// Executes the remaining iterations of a single unit with the kernel bound by the dispatcher.
+template <typename Sha>
+void iterate(unit_t<Sha>& unit, uint32_t iterations)
+{
+    using T = typename Sha::word_t;
+    static constexpr auto template_words = digest_block_template<Sha>();
+    static constexpr auto words = digest_words_k<Sha>;
+    static constexpr auto mask = last_word_mask<Sha>();
+
+    std::array<uint8_t, Sha::message_block_size_k> block;
+    for (size_t i = 0; i < template_words.size(); ++i)
+    {
+        store_big_endian(template_words[i], block.data() + i * sizeof(T));
+    }
+
+    const auto store_digest = [&](const std::array<T, 8>& state)
+    {
+        for (size_t i = 0; i + 1 < words; ++i)
+        {
+            store_big_endian(state[i], block.data() + i * sizeof(T));
+        }
+        store_big_endian(T((state[words - 1] & mask) | template_words[words - 1]), block.data() + (words - 1) * sizeof(T));
+    };
+
+    for (uint32_t iteration = 1; iteration < iterations; ++iteration)
+    {
+        store_digest(unit.u);
+        auto state{ unit.inner };
+        Sha::compress_blocks(state, block.data(), 1);
+
+        store_digest(state);
+        unit.u = unit.outer;
+        Sha::compress_blocks(unit.u, block.data(), 1);
+
+        for (size_t i = 0; i < words; ++i)
+        {
+            unit.t[i] ^= unit.u[i];
+        }
+    }
+}
+
+#if JSRIBAR_SHA2_X86
+
+// Copies digest words of all lanes into the message block, preserving the padding bit in the last digest word.
+template <typename V, typename Sha, size_t N>
+JSRIBAR_SHA2_ALWAYS_INLINE void store_digest_lanes(const multi_buffer::lanes_state_t<Sha, N>& state, multi_buffer::lanes_block_t<Sha, N>& block)
+{
+    static constexpr auto template_words = digest_block_template<Sha>();
+    static constexpr auto words = digest_words_k<Sha>;
+    static constexpr auto mask = last_word_mask<Sha>();
+
+    for (size_t i = 0; i + 1 < words; ++i)
+    {
+        block[i] = state[i];
+    }
+    ((V::load(state[words - 1].data()) & V::broadcast(mask)) | V::broadcast(template_words[words - 1])).store(block[words - 1].data());
+}
+
+// Executes the remaining iterations of N units in N lanes of type V. All units are iterated in lockstep.
+template <typename V, typename Sha, size_t N>
+JSRIBAR_SHA2_ALWAYS_INLINE void iterate_lanes(std::span<unit_t<Sha>> units, uint32_t iterations)
+{
+    static constexpr auto template_words = digest_block_template<Sha>();
+    static constexpr auto words = digest_words_k<Sha>;
+
+    assert(units.size() <= N);
+
+    // Idle lanes are left zero.
+    alignas(64) multi_buffer::lanes_state_t<Sha, N> inner{};
+    alignas(64) multi_buffer::lanes_state_t<Sha, N> outer{};
+    alignas(64) multi_buffer::lanes_state_t<Sha, N> u{};
+    alignas(64) multi_buffer::lanes_state_t<Sha, N> t{};
+    for (size_t lane = 0; lane < units.size(); ++lane)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            inner[i][lane] = units[lane].inner[i];
+            outer[i][lane] = units[lane].outer[i];
+            u[i][lane] = units[lane].u[i];
+            t[i][lane] = units[lane].t[i];
+        }
+    }
+
+    alignas(64) multi_buffer::lanes_block_t<Sha, N> block;
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        block[i].fill(template_words[i]);
+    }
+
+    for (uint32_t iteration = 1; iteration < iterations; ++iteration)
+    {
+        store_digest_lanes<V, Sha, N>(u, block);
+        auto state{ inner };
+        multi_buffer::compress<V, Sha, N>(state, block);
+
+        store_digest_lanes<V, Sha, N>(state, block);
+        u = outer;
+        multi_buffer::compress<V, Sha, N>(u, block);
+
+        for (size_t i = 0; i < words; ++i)
+        {
+            (V::load(t[i].data()) ^ V::load(u[i].data())).store(t[i].data());
+        }
+    }
+
+    for (size_t lane = 0; lane < units.size(); ++lane)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            units[lane].t[i] = t[i][lane];
+        }
+    }
+}
+
+template <typename Sha>
+JSRIBAR_SHA2_TARGET("avx2") void iterate_avx2(std::span<unit_t<Sha>> units, uint32_t iterations)
+{
+    using T = typename Sha::word_t;
+    constexpr size_t lanes = 32 / sizeof(T);
+    for (size_t first = 0; first < units.size(); first += lanes)
+    {
+        iterate_lanes<multi_buffer::lanes_t<T, lanes>, Sha, lanes>(units.subspan(first, std::min(lanes, units.size() - first)), iterations);
+    }
+}
+
+template <typename Sha>
+JSRIBAR_SHA2_TARGET("avx512f") void iterate_avx512(std::span<unit_t<Sha>> units, uint32_t iterations)
+{
+    using T = typename Sha::word_t;
+    constexpr size_t lanes = 64 / sizeof(T);
+    for (size_t first = 0; first < units.size(); first += lanes)
+    {
+        iterate_lanes<multi_buffer::lanes_t<T, lanes>, Sha, lanes>(units.subspan(first, std::min(lanes, units.size() - first)), iterations);
+    }
+}
+
+#endif
+
+// Kernel used to iterate the given number of units. A single unit would leave all lanes but one idle.
+template <typename Sha>
+kernel_t iteration_kernel(size_t units)
+{
+    const auto batch = batch_kernel<Sha>();
+    if (units < 2 || batch_lanes<Sha>(batch) == 1)
+    {
+        return Sha::kernel();
+    }
+    return batch;
+}
+
+}
+
+namespace jsribar::cryptography::sha2
+{
+
+// Derives keys for independent password and salt pairs with the same number of iterations. Key for the i-th
+// pair is written to keys[i]; its size determines the length of the derived key. All output blocks of all keys
+// are iterated in multiple SIMD lanes if supported by CPU.
+template <typename Sha>
+void pbkdf2_batch(std::span<const std::string_view> passwords, std::span<const std::string_view> salts, uint32_t iterations, std::span<const std::span<uint8_t>> keys)
+{
+    assert(passwords.size() == salts.size() && passwords.size() == keys.size());
+    assert(iterations > 0);
+
+    std::vector<pbkdf2_detail::unit_t<Sha>> units;
+    for (size_t i = 0; i < passwords.size(); ++i)
+    {
+        const hmac_key_t<Sha> key{ passwords[i] };
+        for (size_t offset = 0; offset < keys[i].size(); offset += Sha::digest_size_k)
+        {
+            units.push_back(pbkdf2_detail::make_unit(key, salts[i], uint32_t(offset / Sha::digest_size_k + 1)));
+        }
+    }
+
+    switch (pbkdf2_detail::iteration_kernel<Sha>(units.size()))
+    {
+#if JSRIBAR_SHA2_X86
+    case kernel_t::avx512:
+        pbkdf2_detail::iterate_avx512<Sha>(units, iterations);
+        break;
+    case kernel_t::avx2:
+        pbkdf2_detail::iterate_avx2<Sha>(units, iterations);
+        break;
+#endif
+    default:
+        for (auto& unit : units)
+        {
+            pbkdf2_detail::iterate(unit, iterations);
+        }
+        break;
+    }
+
+    auto unit = units.begin();
+    for (const auto& key : keys)
+    {
+        for (size_t offset = 0; offset < key.size(); offset += Sha::digest_size_k, ++unit)
+        {
+            pbkdf2_detail::store_unit(*unit, key.subspan(offset));
+        }
+    }
+}
+
+// Derives key from password and salt. Size of key determines the length of the derived key; if it is longer
+// than digest, output blocks are iterated in multiple SIMD lanes if supported by CPU.
+template <typename Sha>
+void pbkdf2(std::string_view password, std::string_view salt, uint32_t iterations, std::span<uint8_t> key)
+{
+    pbkdf2_batch<Sha>({ &password, 1 }, { &salt, 1 }, iterations, { &key, 1 });
+}
+
+}
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "sha2.hpp"
+
+#include <array>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <utility>
+
+// Digests of resources embedded in the executable (e.g. with #embed or as generated std::array<uint8_t, N>),
+// evaluated entirely at compile time. Compilers limit the number of operations in a single constant expression
+// (see compile_time.cmake) and the limits differ widely: default /constexpr:steps of MSVC allows hashing of only a
+// few hundred bytes by one constexpr call, -fconstexpr-steps of Clang a few KiB, -fconstexpr-ops-limit of GCC
+// about 128 KiB. Resources are therefore appended in chunks, each chunk in a separate constexpr variable that
+// continues from the hasher of the preceding chunk, so that the limit applies to a single chunk only. Default
+// chunk size is chosen per compiler; if the limit is raised, a larger chunk size reduces the number of template
+// instantiations (one per chunk). Chunk states are instantiated in increasing order by a fold expression, so that
+// each of them finds its predecessor already instantiated and the nesting depth does not grow with resource size.
+
+#ifndef JSRIBAR_SHA2_RESOURCE_CHUNK_SIZE
+#if defined(_MSC_VER) && !defined(__clang__)
+#define JSRIBAR_SHA2_RESOURCE_CHUNK_SIZE 256
+#elif defined(__clang__)
+#define JSRIBAR_SHA2_RESOURCE_CHUNK_SIZE 4096
+#else
+#define JSRIBAR_SHA2_RESOURCE_CHUNK_SIZE 16384
+#endif
+#endif
+
+namespace jsribar::cryptography::sha2
+{
+
+namespace resource_detail
+{
+
+constexpr size_t chunk_size_k{ JSRIBAR_SHA2_RESOURCE_CHUNK_SIZE };
+
+template <const auto& Resource>
+constexpr auto bytes(size_t offset, size_t length)
+{
+    return std::span{ std::ranges::data(Resource) + offset, length };
+}
+
+template <typename Sha, const auto& Resource, size_t Chunks>
+constexpr Sha append_chunk();
+
+// Hasher with the first Chunks chunks of the resource appended.
+template <typename Sha, const auto& Resource, size_t Chunks>
+constexpr Sha chunk_state_k{ append_chunk<Sha, Resource, Chunks>() };
+
+template <typename Sha, const auto& Resource>
+constexpr Sha chunk_state_k<Sha, Resource, 0>{};
+
+template <typename Sha, const auto& Resource, size_t Chunks>
+constexpr Sha append_chunk()
+{
+    auto sh{ chunk_state_k<Sha, Resource, Chunks - 1> };
+    sh.update(bytes<Resource>((Chunks - 1) * chunk_size_k, chunk_size_k));
+    return sh;
+}
+
+// Hasher with all Chunks chunks appended; a fold rather than a direct reference to the last chunk state, which
+// would instantiate all preceding states recursively (one nesting level per chunk).
+template <typename Sha, const auto& Resource, size_t... Chunks>
+constexpr Sha chunks_state(std::index_sequence<Chunks...>)
+{
+    Sha sh{};
+    ((sh = chunk_state_k<Sha, Resource, Chunks + 1>), ...);
+    return sh;
+}
+
+template <typename Sha, const auto& Resource>
+constexpr typename Sha::message_digest_t resource_digest()
+{
+    constexpr size_t size = std::ranges::size(Resource);
+    constexpr size_t chunks = size / chunk_size_k;
+
+    auto sh{ chunks_state<Sha, Resource>(std::make_index_sequence<chunks>{}) };
+    sh.update(bytes<Resource>(chunks * chunk_size_k, size - chunks * chunk_size_k));
+    return sh.finalize();
+}
+
+}
+
+// Digest of a resource with static storage duration: a contiguous range of characters or bytes, e.g.
+// constexpr unsigned char blob[]{ #embed "blob.bin" } or constexpr std::array<uint8_t, N>. Unlike string
+// literals passed to sha256(), all elements of a character array are hashed, since #embed adds no terminator.
+template <typename Sha, const auto& Resource>
+    requires std::ranges::contiguous_range<decltype(Resource)> && byte_like<std::ranges::range_value_t<decltype(Resource)>>
+constexpr typename Sha::message_digest_t digest_of{ resource_detail::resource_digest<Sha, Resource>() };
+
+template <const auto& Resource>
+constexpr auto sha224_of{ digest_of<sha224_t, Resource> };
+
+template <const auto& Resource>
+constexpr auto sha256_of{ digest_of<sha256_t, Resource> };
+
+template <const auto& Resource>
+constexpr auto sha384_of{ digest_of<sha384_t, Resource> };
+
+template <const auto& Resource>
+constexpr auto sha512_of{ digest_of<sha512_t, Resource> };
+
+template <const auto& Resource>
+constexpr auto sha512_224_of{ digest_of<sha512_224_t, Resource> };
+
+template <const auto& Resource>
+constexpr auto sha512_256_of{ digest_of<sha512_256_t, Resource> };
+
+}
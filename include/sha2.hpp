@@ -29,13 +29,17 @@
 
 #pragma once
 
+#include "dispatch.hpp"
 #include "util.hpp"
 
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <ranges>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 // Implementation of SHA-2 algorithms that enables compile time evaluation of string digests.
 // For technical details check: https://en.wikipedia.org/wiki/SHA-2
@@ -43,205 +47,517 @@
 namespace jsribar::cryptography::sha2
 {
 
-// Sum implementations for SHA-224/SHA-256 and SHA-384/SHA-512, respectively.
+// Sum implementations for SHA-224/SHA-256 and SHA-384/SHA-512, respectively. Rotations are written out instead of
+// calling right_rotate() since each call adds to the cost of constant evaluation.
 constexpr uint32_t sum0(uint32_t w)
 {
-    return right_rotate(w, 7) ^ right_rotate(w, 18) ^ (w >> 3);
+    return ((w >> 7) | (w << 25)) ^ ((w >> 18) | (w << 14)) ^ (w >> 3);
 }
 
 constexpr uint32_t sum1(uint32_t w)
 {
-    return right_rotate(w, 17) ^ right_rotate(w, 19) ^ (w >> 10);
+    return ((w >> 17) | (w << 15)) ^ ((w >> 19) | (w << 13)) ^ (w >> 10);
 }
 
 constexpr uint64_t sum0(uint64_t w)
 {
-    return right_rotate(w, 1) ^ right_rotate(w, 8) ^ (w >> 7);
+    return ((w >> 1) | (w << 63)) ^ ((w >> 8) | (w << 56)) ^ (w >> 7);
 }
 
 constexpr uint64_t sum1(uint64_t w)
 {
-    return right_rotate(w, 19) ^ right_rotate(w, 61) ^ (w >> 6);
+    return ((w >> 19) | (w << 45)) ^ ((w >> 61) | (w << 3)) ^ (w >> 6);
 }
 
 // Sigma implementations for SHA-224/SHA-256 and SHA-384/SHA-512, respectively.
 constexpr uint32_t sigma0(uint32_t h)
 {
-    return right_rotate(h, 2) ^ right_rotate(h, 13) ^ right_rotate(h, 22);
+    return ((h >> 2) | (h << 30)) ^ ((h >> 13) | (h << 19)) ^ ((h >> 22) | (h << 10));
 }
 
 constexpr uint32_t sigma1(uint32_t h)
 {
-    return right_rotate(h, 6) ^ right_rotate(h, 11) ^ right_rotate(h, 25);
+    return ((h >> 6) | (h << 26)) ^ ((h >> 11) | (h << 21)) ^ ((h >> 25) | (h << 7));
 }
 
 constexpr uint64_t sigma0(uint64_t h)
 {
-    return right_rotate(h, 28) ^ right_rotate(h, 34) ^ right_rotate(h, 39);
+    return ((h >> 28) | (h << 36)) ^ ((h >> 34) | (h << 30)) ^ ((h >> 39) | (h << 25));
 }
 
 constexpr uint64_t sigma1(uint64_t h)
 {
-    return right_rotate(h, 14) ^ right_rotate(h, 18) ^ right_rotate(h, 41);
+    return ((h >> 14) | (h << 50)) ^ ((h >> 18) | (h << 46)) ^ ((h >> 41) | (h << 23));
 }
 
 // Base class for all implementations.
-template <typename T, typename InitialHashValues, typename RoundConstants, size_t message_schedule_length, size_t digest_size>
+template <typename T, typename InitialHashValues, typename RoundConstants, size_t digest_size>
 class sha_base_t
 {
 protected:
+    constexpr sha_base_t() = default;
+
     constexpr explicit sha_base_t(const char* input, size_t length)
-        : message_begin_m(input)
-        , message_end_m(input + length)
-        , message_length_m(length)
     {
-        do
+        if (length < last_block_size_k)
+        {
+            hash_single_block(input, length);
+            return;
+        }
+        update(input, length);
+        finalize();
+    }
+
+public:
+    using word_t = T;
+    using initial_hash_values_t = InitialHashValues;
+    using round_constants_t = RoundConstants;
+
+    static constexpr size_t message_block_size_k{ sizeof(T) * 16 };
+    static constexpr size_t digest_size_k{ digest_size };
+
+    using message_digest_t = std::array<uint8_t, digest_size>;
+    using message_block_t = std::array<uint8_t, message_block_size_k>;
+
+    // Appends next chunk of the message. Chunks can be of arbitrary length: incomplete message block
+    // is buffered internally until further data arrives or finalize() is called. Complete message blocks
+    // are compressed directly from the input, all of them in a single call of the kernel, so that only
+    // the leading and trailing parts of the chunk are copied to the buffer.
+    constexpr void update(const char* input, size_t length)
+    {
+        append(input, length);
+    }
+
+    constexpr void update(std::string_view input)
+    {
+        append(input.data(), input.size());
+    }
+
+    // Appends a range of characters or bytes (e.g. std::span<const std::byte>, std::vector<uint8_t> or a view
+    // such as std::views::join). Contiguous ranges are appended as a single chunk, other ranges element by
+    // element. Arrays are excluded, so that string literals are appended without the terminating null
+    // character (by the std::string_view overload).
+    template <std::ranges::input_range Range>
+        requires byte_like<std::ranges::range_value_t<Range>> && (!std::is_array_v<std::remove_cvref_t<Range>>)
+    constexpr void update(Range&& input)
+    {
+        if constexpr (std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>)
+        {
+            append(std::ranges::data(input), size_t(std::ranges::size(input)));
+        }
+        else
         {
-            if (const auto copied = copy_message_block(); copied < message_block_size_k)
+            assert(!finalized_m);
+
+            for (auto&& byte : input)
             {
-                pad_last_block(copied);
+                message_block_m[buffered_m] = uint8_t(byte);
+                ++message_length_m;
+                if (++buffered_m == message_block_size_k)
+                {
+                    compress(message_block_m.data());
+                    buffered_m = 0;
+                }
             }
-            extend_message_schedule();
-            compress();
-        } while (message_begin_m < message_end_m || padding_m != padding_t::size);
+        }
+    }
 
-        final_hash();
+    // Appends fragments of the message (scatter-gather input), e.g. std::span<const std::span<const uint8_t>>
+    // or header and body as std::array<std::string_view, 2>, without concatenating them first.
+    template <std::ranges::input_range Range>
+        requires std::ranges::input_range<std::ranges::range_reference_t<Range>>
+            && byte_like<std::ranges::range_value_t<std::ranges::range_reference_t<Range>>>
+    constexpr void update(Range&& fragments)
+    {
+        for (auto&& fragment : fragments)
+        {
+            update(fragment);
+        }
     }
 
-public:
-    using message_digest_t = std::array<uint8_t, digest_size>;
-    using message_schedule_t = std::array<uint8_t, message_schedule_length>;
+    // Pads the message, processes remaining message block(s) and evaluates the digest. Once finalized,
+    // no more data can be appended and each subsequent call returns the same digest.
+    constexpr message_digest_t finalize()
+    {
+        if (!finalized_m)
+        {
+            pad_last_block();
+            finalized_m = true;
+        }
+        return final_hash();
+    }
 
+    // Returns digest of the message. If hasher has not been finalized yet, returns digest of the data
+    // appended so far, leaving hasher state intact so that more data can be appended.
     constexpr message_digest_t digest() const
     {
-        return message_digest_m;
+        if (finalized_m)
+        {
+            return final_hash();
+        }
+        auto copy{ *this };
+        return copy.finalize();
     }
 
-private:
-    const char* message_begin_m{ nullptr };
-    const char* message_end_m{ nullptr };
+    // Intermediate hash values and number of bytes appended so far. Together they describe the state
+    // of hasher if message length is a multiple of message block size, so that no data is buffered.
+    constexpr const std::array<T, 8>& hash_values() const
+    {
+        return h_m;
+    }
+
+    constexpr uint64_t message_length() const
+    {
+        return message_length_m;
+    }
+
+    // Kernel that compresses message blocks at runtime.
+    static kernel_t kernel()
+    {
+        return dispatch::dispatcher_t<RoundConstants, T, &sha_base_t::compress_portable>::kernel();
+    }
+
+    // Compresses complete message blocks, at runtime with the kernel bound by the dispatcher. Enables
+    // algorithms built on top of the hash function (e.g. PBKDF2) to skip buffering and padding.
+    static constexpr void compress_blocks(std::array<T, 8>& state, const uint8_t* blocks, size_t count)
+    {
+        if (std::is_constant_evaluated())
+        {
+            for (; count > 0; --count, blocks += message_block_size_k)
+            {
+                compress_constant_evaluated(state, blocks);
+            }
+        }
+        else
+        {
+            dispatch::dispatcher_t<RoundConstants, T, &sha_base_t::compress_portable>::compress(state, blocks, count);
+        }
+    }
+
+    // Message schedule words with round constants added.
+    using message_schedule_t = std::array<T, RoundConstants{}.size()>;
+
+    // Evaluates message schedule of a message block. If the block is known in advance (e.g. a block that
+    // consists of padding only), its schedule can be evaluated at compile time, so that compress_scheduled()
+    // only executes rounds.
+    static constexpr message_schedule_t message_schedule(const uint8_t* block)
+    {
+        message_schedule_t w{};
+        for (size_t i = 0; i < 16; ++i)
+        {
+            w[i] = to_uint<T>(block + i * sizeof(T));
+        }
+        for (size_t i = 16; i < w.size(); ++i)
+        {
+            w[i] = w[i - 16] + sum0(w[i - 15]) + w[i - 7] + sum1(w[i - 2]);
+        }
+        message_schedule_t wk{};
+        for (size_t i = 0; i < wk.size(); ++i)
+        {
+            wk[i] = k_k[i] + w[i];
+        }
+        return wk;
+    }
 
-    const size_t message_length_m{ 0 };
+    // Compresses message block with precomputed message schedule. At runtime, SHA extensions are used if
+    // the bound kernel uses them; otherwise rounds are executed in portable code.
+    static constexpr void compress_scheduled(std::array<T, 8>& state, const message_schedule_t& wk)
+    {
+#if JSRIBAR_SHA2_X86
+        if constexpr (std::is_same_v<T, uint32_t>)
+        {
+            if (!std::is_constant_evaluated() && kernel() == kernel_t::sha_ni)
+            {
+                sha_ni::compress_scheduled(state, wk);
+                return;
+            }
+        }
+#endif
 
-    message_schedule_t message_schedule_m{ 0 };
-    message_digest_t message_digest_m{ 0 };
+        T a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+        for (size_t i = 0; i < rounds_k; i += 8)
+        {
+            round(a, b, c, d, e, f, g, h, wk[i]);
+            round(h, a, b, c, d, e, f, g, wk[i + 1]);
+            round(g, h, a, b, c, d, e, f, wk[i + 2]);
+            round(f, g, h, a, b, c, d, e, wk[i + 3]);
+            round(e, f, g, h, a, b, c, d, wk[i + 4]);
+            round(d, e, f, g, h, a, b, c, wk[i + 5]);
+            round(c, d, e, f, g, h, a, b, wk[i + 6]);
+            round(b, c, d, e, f, g, h, a, wk[i + 7]);
+        }
 
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+
+    // Converts hash values to digest, trimming the rightmost surplus bytes if digest is smaller than the state.
+    static constexpr message_digest_t to_digest(const std::array<T, 8>& state)
+    {
+        message_digest_t digest{};
+        for (size_t i = 0; i < digest_size / sizeof(T); ++i)
+        {
+            store_big_endian(state[i], &digest[i * sizeof(T)]);
+        }
+        if constexpr (digest_size % sizeof(T) != 0)
+        {
+            constexpr auto i = digest_size / sizeof(T);
+            to_uint8_array(state[i], &digest[i * sizeof(T)], int(digest_size % sizeof(T)));
+        }
+        return digest;
+    }
+
+private:
     static constexpr InitialHashValues initial_hash_values_k{};
 
+    // Digest is not stored but evaluated from the hash values on request, so that the object consists of hash
+    // values, message length and the block buffer only.
     std::array<T, 8> h_m{ initial_hash_values_k.values };
 
-    static constexpr RoundConstants k_k{};
+    uint64_t message_length_m{ 0 };
 
-    // Padding(s) done.
-    enum class padding_t
-    {
-        none,
-        bit_one,
-        size,
-    };
+    message_block_t message_block_m{ 0 };
 
-    padding_t padding_m{ padding_t::none };
+    // Number of bytes of the current message block buffered.
+    uint8_t buffered_m{ 0 };
 
-    static constexpr size_t message_block_size_k{ sizeof(T) * 16 };
+    bool finalized_m{ false };
+
+    static constexpr RoundConstants k_k{};
+    static constexpr size_t rounds_k{ k_k.size() };
+    static_assert(rounds_k % 8 == 0);
 
     static constexpr uint8_t padding_bit_one_k{ 0x80 };
     static constexpr size_t last_block_size_k{ message_block_size_k - 2 * sizeof(T) };
 
 
-    constexpr size_t copy_message_block()
+    template <typename Byte>
+    constexpr void append(const Byte* input, size_t length)
     {
-        const auto to_copy = std::min(size_t(message_end_m - message_begin_m), message_block_size_k);
-        std::copy(message_begin_m, message_begin_m + to_copy, message_schedule_m.data());
-        message_begin_m += to_copy;
-        return to_copy;
+        assert(!finalized_m);
+
+        message_length_m += length;
+        if (buffered_m > 0)
+        {
+            const auto copied = copy_message_block(input, length);
+            if (buffered_m < message_block_size_k)
+            {
+                return;
+            }
+            compress(message_block_m.data());
+            buffered_m = 0;
+            input += copied;
+            length -= copied;
+        }
+
+        if (const auto blocks = length / message_block_size_k; blocks > 0)
+        {
+            if (std::is_constant_evaluated())
+            {
+                for (size_t i = 0; i < blocks; ++i)
+                {
+                    compress_constant_evaluated(h_m, input + i * message_block_size_k);
+                }
+            }
+            else
+            {
+                compress_blocks(h_m, reinterpret_cast<const uint8_t*>(input), blocks);
+            }
+            input += blocks * message_block_size_k;
+            length -= blocks * message_block_size_k;
+        }
+
+        copy_message_block(input, length);
     }
 
-    // Append single '1' bit to the message and add original message length to the end of the message block.
-    constexpr void pad_last_block(size_t copied_input_block_length)
+    template <typename Byte>
+    constexpr size_t copy_message_block(const Byte* input, size_t length)
     {
-        assert(copied_input_block_length < message_block_size_k);
-
-        if (padding_m == padding_t::none)
+        const auto to_copy = std::min(length, message_block_size_k - buffered_m);
+        if constexpr (std::is_same_v<Byte, std::byte>)
+        {
+            std::transform(input, input + to_copy, message_block_m.data() + buffered_m, [](std::byte byte) { return uint8_t(byte); });
+        }
+        else
         {
-            message_schedule_m.at(copied_input_block_length) = padding_bit_one_k;
-            ++copied_input_block_length;
-            padding_m = padding_t::bit_one;
+            std::copy(input, input + to_copy, message_block_m.data() + buffered_m);
         }
+        buffered_m += uint8_t(to_copy);
+        return to_copy;
+    }
+
+    // Short message (up to 55 bytes for SHA-224/SHA-256, 111 bytes for the others) fits into a single message block
+    // together with the padding, so the padded block is built at once and compressed, without buffering.
+    constexpr void hash_single_block(const char* input, size_t length)
+    {
+        std::copy_n(input, length, message_block_m.data());
+        message_block_m[length] = padding_bit_one_k;
+        append_message_length(message_block_m.data() + last_block_size_k, length * 8);
+        compress(message_block_m.data());
+        message_length_m = length;
+        finalized_m = true;
+    }
 
-        const auto beg = message_schedule_m.data() + copied_input_block_length;
-        if (copied_input_block_length <= last_block_size_k)
+    // Append single '1' bit to the message and add original message length to the end of the last message block.
+    // If there is no room left for the message length, an additional message block is appended.
+    constexpr void pad_last_block()
+    {
+        assert(buffered_m < message_block_size_k);
+
+        message_block_m.at(buffered_m) = padding_bit_one_k;
+
+        const auto beg = message_block_m.data() + buffered_m + 1;
+        if (buffered_m >= last_block_size_k)
         {
-            auto end = message_schedule_m.data() + last_block_size_k;
-            std::fill(beg, end, 0);
-            append_message_length(end, message_length_m * 8);
-            padding_m = padding_t::size;
+            std::fill(beg, message_block_m.data() + message_block_size_k, 0);
+            compress(message_block_m.data());
+            std::fill(message_block_m.data(), message_block_m.data() + last_block_size_k, 0);
         }
         else
         {
-            std::fill(beg, message_schedule_m.data() + message_block_size_k, 0);
+            std::fill(beg, message_block_m.data() + last_block_size_k, 0);
         }
+
+        append_message_length(message_block_m.data() + last_block_size_k, message_length_m * 8);
+        compress(message_block_m.data());
+        buffered_m = 0;
     }
 
-    constexpr void append_message_length(uint8_t* destination, size_t length) const
+    constexpr void append_message_length(uint8_t* destination, uint64_t length) const
     {
         to_uint8_array(length, destination, sizeof(T) * 2);
     }
 
-    // Extend the first 16 words into the remaining words w[16..63] (or w[16..79] for SHA-512) of the message schedule array.
-    constexpr void extend_message_schedule()
+    // At runtime, kernel bound by the dispatcher is used (see dispatch.hpp).
+    constexpr void compress(const uint8_t* block)
     {
-        for (size_t offset = 0; offset < message_schedule_length - 16 * sizeof(T); offset += sizeof(T))
+        if (std::is_constant_evaluated())
         {
-            auto off = message_schedule_m.data() + offset;
-            const auto w0 = to_uint<T>(off);
+            compress_constant_evaluated(h_m, block);
+        }
+        else
+        {
+            compress_blocks(h_m, block, 1);
+        }
+    }
 
-            off += sizeof(T);
-            const auto w1 = to_uint<T>(off);
+    // Message schedule words w[16..63] (or w[16..79] for SHA-512) are evaluated on the fly while rounds are
+    // executed. Since each word depends only on the preceding 16 words, they are kept in a rolling buffer.
+    // Rounds are unrolled at compile time.
+    static constexpr void compress_portable(std::array<T, 8>& state, const uint8_t* blocks, size_t count)
+    {
+        for (; count > 0; --count, blocks += message_block_size_k)
+        {
+            std::array<T, 16> w;
+            for (size_t i = 0; i < w.size(); ++i)
+            {
+                w[i] = load_big_endian<T>(blocks + i * sizeof(T));
+            }
 
-            off += 8 * sizeof(T);
-            const auto w2 = to_uint<T>(off);
+            std::array<T, 8> h{ state };
 
-            off += 5 * sizeof(T);
-            const auto w3 = to_uint<T>(off);
+            [&]<size_t... i>(std::index_sequence<i...>)
+            {
+                (round<i>(h, w), ...);
+            }(std::make_index_sequence<rounds_k>{});
 
-            off += 2 * sizeof(T);
-            const auto w4 = w0 + sum0(w1) + w2 + sum1(w3);
-            to_uint8_array(w4, off);
+            for (size_t i = 0; i < state.size(); ++i)
+            {
+                state[i] += h[i];
+            }
         }
     }
 
-    constexpr void compress()
+    // Compilers limit constant evaluation by the number of operations (GCC) or statements (Clang, MSVC) evaluated,
+    // including function calls and loop iterations, rather than by the generated code. Therefore all message schedule
+    // words are evaluated in advance in plain loops and working variables are kept in locals: instead of being shifted
+    // after each round, their roles are rotated in eight calls per loop iteration. Block can be read directly from
+    // the input (see update()).
+    template <typename Byte>
+    static constexpr void compress_constant_evaluated(std::array<T, 8>& state, const Byte* block)
     {
-        std::array<T, 8> h{ h_m };
-
-        for (int i = 0; i < k_k.size(); ++i)
+        T w[rounds_k];
+        for (size_t i = 0; i < 16; ++i)
+        {
+            w[i] = to_uint<T>(block + i * sizeof(T));
+        }
+        for (size_t i = 16; i < rounds_k; ++i)
         {
-            const auto choice = (h[4] & h[5]) ^ ((~h[4]) & h[6]);
-            const auto temp1 = h[7] + sigma1(h[4]) + choice + k_k[i] + to_uint<T>(message_schedule_m.data() + i * sizeof(T));
-            const auto majority = (h[0] & h[1]) ^ (h[0] & h[2]) ^ (h[1] & h[2]);
-            const auto temp2 = sigma0(h[0]) + majority;
-
-            std::ranges::rotate(h, h.end() - 1);
-            h[0] = temp1 + temp2;
-            h[4] += temp1;
+            w[i] = w[i - 16] + sum0(w[i - 15]) + w[i - 7] + sum1(w[i - 2]);
         }
 
-        for (size_t i = 0; i < h_m.size(); ++i)
+        T a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+        for (size_t i = 0; i < rounds_k; i += 8)
         {
-            h_m[i] += h[i];
+            round(a, b, c, d, e, f, g, h, k_k[i] + w[i]);
+            round(h, a, b, c, d, e, f, g, k_k[i + 1] + w[i + 1]);
+            round(g, h, a, b, c, d, e, f, k_k[i + 2] + w[i + 2]);
+            round(f, g, h, a, b, c, d, e, k_k[i + 3] + w[i + 3]);
+            round(e, f, g, h, a, b, c, d, k_k[i + 4] + w[i + 4]);
+            round(d, e, f, g, h, a, b, c, k_k[i + 5] + w[i + 5]);
+            round(c, d, e, f, g, h, a, b, k_k[i + 6] + w[i + 6]);
+            round(b, c, d, e, f, g, h, a, k_k[i + 7] + w[i + 7]);
         }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
     }
 
-    constexpr void final_hash()
+    // Single round for compress_constant_evaluated() and compress_scheduled(): only d and h are modified, becoming
+    // e and a of the next round.
+    static constexpr void round(T a, T b, T c, T& d, T e, T f, T g, T& h, T kw)
     {
-        // If final digest is smaller than evaluated, trim the rightmost surplus bits.
-        int digest_len = digest_size;
-        for (size_t i = 0; i < h_m.size() && digest_len > 0; ++i)
+        h += sigma1(e) + (g ^ (e & (f ^ g))) + kw;
+        d += h;
+        h += sigma0(a) + ((a & b) | (c & (a | b)));
+    }
+
+    // Instead of shifting working variables a..h after each round, their positions in the array are
+    // rotated: in the round i, variable a is at the position -i (mod 8), b at 1 - i (mod 8), etc.
+    // Since all positions are compile time constants, the entire state can be kept in registers.
+    template <size_t i>
+    static constexpr void round(std::array<T, 8>& h, std::array<T, 16>& w)
+    {
+        constexpr auto at = [](size_t variable) { return (variable + 8 - i % 8) % 8; };
+
+        if constexpr (i >= 16)
         {
-            const auto len = std::min<int>(sizeof(T), digest_len);
-            to_uint8_array(h_m[i], &message_digest_m[i * sizeof(T)], len);
-            digest_len -= len;
+            w[i % 16] += sum0(w[(i + 1) % 16]) + w[(i + 9) % 16] + sum1(w[(i + 14) % 16]);
         }
+
+        const T& a = h[at(0)];
+        const T& b = h[at(1)];
+        const T& c = h[at(2)];
+        T& d = h[at(3)];
+        const T& e = h[at(4)];
+        const T& f = h[at(5)];
+        const T& g = h[at(6)];
+        T& hh = h[at(7)];
+
+        const auto choice = (e & f) ^ ((~e) & g);
+        const auto temp1 = hh + sigma1(e) + choice + k_k[i] + w[i % 16];
+        const auto majority = (a & b) ^ (a & c) ^ (b & c);
+        const auto temp2 = sigma0(a) + majority;
+
+        d += temp1;
+        hh = temp1 + temp2;
+    }
+
+    constexpr message_digest_t final_hash() const
+    {
+        return to_digest(h_m);
     }
 };
 
@@ -249,7 +565,7 @@ private:
 class round_constants_2x_t
 {
 public:
-    constexpr uint32_t operator[](int index) const
+    constexpr uint32_t operator[](size_t index) const
     {
         return values[index];
     }
@@ -281,9 +597,11 @@ struct initital_hash_values_224_t
 };
 
 // SHA-224 implementation.
-class sha224_t : public sha_base_t<uint32_t, initital_hash_values_224_t, round_constants_2x_t, 256, 28>
+class sha224_t : public sha_base_t<uint32_t, initital_hash_values_224_t, round_constants_2x_t, 28>
 {
 public:
+    constexpr sha224_t() = default;
+
     constexpr sha224_t(std::initializer_list<char> input)
         : sha_base_t(input.begin(), input.size())
     {
@@ -309,9 +627,11 @@ struct initial_hash_values_256_t
 };
 
 // SHA-256 implementation.
-class sha256_t : public sha_base_t<uint32_t, initial_hash_values_256_t, round_constants_2x_t, 256, 32>
+class sha256_t : public sha_base_t<uint32_t, initial_hash_values_256_t, round_constants_2x_t, 32>
 {
 public:
+    constexpr sha256_t() = default;
+
     constexpr sha256_t(std::initializer_list<char> input)
         : sha_base_t(input.begin(), input.size())
     {
@@ -332,7 +652,7 @@ public:
 class round_constants_5x_t
 {
 public:
-    constexpr uint64_t operator[](int index) const
+    constexpr uint64_t operator[](size_t index) const
     {
         return values[index];
     }
@@ -373,9 +693,11 @@ struct initial_hash_values_384_t
 };
 
 // SHA-384 implementation.
-class sha384_t : public sha_base_t<uint64_t, initial_hash_values_384_t, round_constants_5x_t, 640, 48>
+class sha384_t : public sha_base_t<uint64_t, initial_hash_values_384_t, round_constants_5x_t, 48>
 {
 public:
+    constexpr sha384_t() = default;
+
     constexpr sha384_t(std::initializer_list<char> input)
         : sha_base_t(input.begin(), input.size())
     {
@@ -402,9 +724,11 @@ struct initial_hash_values_512_t
 };
 
 // SHA-512 implementation.
-class sha512_t : public sha_base_t<uint64_t, initial_hash_values_512_t, round_constants_5x_t, 640, 64>
+class sha512_t : public sha_base_t<uint64_t, initial_hash_values_512_t, round_constants_5x_t, 64>
 {
 public:
+    constexpr sha512_t() = default;
+
     constexpr sha512_t(std::initializer_list<char> input)
         : sha_base_t(input.begin(), input.size())
     {
@@ -431,9 +755,11 @@ struct initial_hash_values_512_224_t
 };
 
 // SHA-512/224 implementation.
-class sha512_224_t : public sha_base_t<uint64_t, initial_hash_values_512_224_t, round_constants_5x_t, 640, 28>
+class sha512_224_t : public sha_base_t<uint64_t, initial_hash_values_512_224_t, round_constants_5x_t, 28>
 {
 public:
+    constexpr sha512_224_t() = default;
+
     constexpr sha512_224_t(std::initializer_list<char> input)
         : sha_base_t(input.begin(), input.size())
     {
@@ -460,9 +786,11 @@ struct initial_hash_values_512_256_t
 };
 
 // SHA-512/256 implementation.
-class sha512_256_t : public sha_base_t<uint64_t, initial_hash_values_512_256_t, round_constants_5x_t, 640, 32>
+class sha512_256_t : public sha_base_t<uint64_t, initial_hash_values_512_256_t, round_constants_5x_t, 32>
 {
 public:
+    constexpr sha512_256_t() = default;
+
     constexpr sha512_256_t(std::initializer_list<char> input)
         : sha_base_t(input.begin(), input.size())
     {
@@ -479,4 +807,58 @@ public:
     }
 };
 
+// Free functions return the digest only, without hasher state. E.g. a table of digests evaluated at compile time
+// then occupies only digest_size_k bytes per entry.
+constexpr sha224_t::message_digest_t sha224(std::string_view input)
+{
+    return sha224_t{ input }.digest();
+}
+
+constexpr sha256_t::message_digest_t sha256(std::string_view input)
+{
+    return sha256_t{ input }.digest();
+}
+
+constexpr sha384_t::message_digest_t sha384(std::string_view input)
+{
+    return sha384_t{ input }.digest();
+}
+
+constexpr sha512_t::message_digest_t sha512(std::string_view input)
+{
+    return sha512_t{ input }.digest();
+}
+
+constexpr sha512_224_t::message_digest_t sha512_224(std::string_view input)
+{
+    return sha512_224_t{ input }.digest();
+}
+
+constexpr sha512_256_t::message_digest_t sha512_256(std::string_view input)
+{
+    return sha512_256_t{ input }.digest();
+}
+
+// Returns hasher with a known prefix appended but not finalized, i.e. the intermediate hash values together with
+// the pending partial block and message length. Evaluated at compile time, it removes compression of the prefix
+// from the runtime: copy of the hasher only needs the variable suffix appended. Hashers are trivially copyable,
+// so a running state can be forked cheaply (e.g. to take snapshots of a transcript hash).
+template <typename Sha>
+constexpr Sha midstate(std::string_view prefix)
+{
+    Sha sh;
+    sh.update(prefix);
+    return sh;
+}
+
+// Evaluates digest of a message given as a range of characters or bytes or as a range of its fragments (see update()),
+// without concatenating it into a contiguous buffer first.
+template <typename Sha, typename Range>
+constexpr typename Sha::message_digest_t hash_range(Range&& input)
+{
+    Sha sh;
+    sh.update(std::forward<Range>(input));
+    return sh.finalize();
+}
+
 }
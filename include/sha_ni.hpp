@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "cpu_features.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if JSRIBAR_SHA2_X86
+#include <immintrin.h>
+#endif
+
+// SHA-224/SHA-256 compression using Intel SHA extensions (SHA256RNDS2, SHA256MSG1, SHA256MSG2).
+// Each SHA256RNDS2 instruction executes two rounds; state is kept in two registers as ABEF and CDGH.
+
+#if JSRIBAR_SHA2_X86
+
+namespace jsribar::cryptography::sha2::sha_ni
+{
+
+// Loads four big-endian words of the message block.
+JSRIBAR_SHA2_TARGET("sha,sse4.1") inline __m128i load(const uint8_t* input)
+{
+    const auto byte_order = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input)), byte_order);
+}
+
+// Evaluates next four message schedule words from the preceding 16 words.
+JSRIBAR_SHA2_TARGET("sha,sse4.1") inline __m128i schedule(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    const auto w = _mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), _mm_alignr_epi8(w3, w2, 4));
+    return _mm_sha256msg2_epu32(w, w3);
+}
+
+// Executes four rounds.
+JSRIBAR_SHA2_TARGET("sha,sse4.1") inline void rounds(__m128i& abef, __m128i& cdgh, __m128i w, const uint32_t* k)
+{
+    const auto wk = _mm_add_epi32(w, _mm_loadu_si128(reinterpret_cast<const __m128i*>(k)));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0E));
+}
+
+// Compresses consecutive message blocks into the hash state.
+template <typename RoundConstants>
+JSRIBAR_SHA2_TARGET("sha,sse4.1") void compress(std::array<uint32_t, 8>& h, const uint8_t* blocks, size_t count)
+{
+    static constexpr auto k = []
+    {
+        std::array<uint32_t, 64> values{};
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = RoundConstants{}[i];
+        }
+        return values;
+    }();
+
+    const auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&h[0])), 0xB1);
+    const auto efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&h[4])), 0x1B);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+
+    for (; count > 0; --count, blocks += 64)
+    {
+        const auto abef_saved = abef;
+        const auto cdgh_saved = cdgh;
+
+        auto w0 = load(blocks + 0);
+        rounds(abef, cdgh, w0, &k[0]);
+        auto w1 = load(blocks + 16);
+        rounds(abef, cdgh, w1, &k[4]);
+        auto w2 = load(blocks + 32);
+        rounds(abef, cdgh, w2, &k[8]);
+        auto w3 = load(blocks + 48);
+        rounds(abef, cdgh, w3, &k[12]);
+
+        for (size_t i = 16; i < k.size(); i += 16)
+        {
+            w0 = schedule(w0, w1, w2, w3);
+            rounds(abef, cdgh, w0, &k[i]);
+            w1 = schedule(w1, w2, w3, w0);
+            rounds(abef, cdgh, w1, &k[i + 4]);
+            w2 = schedule(w2, w3, w0, w1);
+            rounds(abef, cdgh, w2, &k[i + 8]);
+            w3 = schedule(w3, w0, w1, w2);
+            rounds(abef, cdgh, w3, &k[i + 12]);
+        }
+
+        abef = _mm_add_epi32(abef, abef_saved);
+        cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+    }
+
+    const auto feba = _mm_shuffle_epi32(abef, 0x1B);
+    const auto dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&h[0]), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&h[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+// Compresses a message block with message schedule precomputed (e.g. for a block that consists of padding only):
+// wk holds message schedule words with round constants added, so that only rounds are executed.
+JSRIBAR_SHA2_TARGET("sha,sse4.1") inline void compress_scheduled(std::array<uint32_t, 8>& h, const std::array<uint32_t, 64>& wk)
+{
+    const auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&h[0])), 0xB1);
+    const auto efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&h[4])), 0x1B);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+    const auto abef_saved = abef;
+    const auto cdgh_saved = cdgh;
+
+    for (size_t i = 0; i < wk.size(); i += 4)
+    {
+        rounds(abef, cdgh, _mm_setzero_si128(), &wk[i]);
+    }
+
+    abef = _mm_add_epi32(abef, abef_saved);
+    cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+
+    const auto feba = _mm_shuffle_epi32(abef, 0x1B);
+    const auto dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&h[0]), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&h[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+}
+
+#endif
@@ -0,0 +1,361 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "fixed_length.hpp"
+#include "multi_buffer.hpp"
+#include "sha2.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Tree hash of Amazon S3 Glacier: SHA-256 digests of 1 MiB chunks of the message are concatenated pairwise and
+// hashed, level by level, up to the root; an odd digest at the end of a level is promoted to the next level
+// unchanged. Unlike the digest of the whole message, chunks can be hashed in parallel: they are distributed over
+// threads, and each thread hashes its chunks in multiple SIMD lanes (see hash_batch()). Glacier requires the
+// linear SHA-256 of the whole message as well; it is evaluated in the same pass by another thread.
+
+namespace jsribar::cryptography::sha2
+{
+
+constexpr size_t tree_hash_chunk_size_k{ size_t(1) << 20 };
+
+struct tree_hash_t
+{
+    sha256_t::message_digest_t tree{};
+    // Left zero if the linear digest is not evaluated.
+    sha256_t::message_digest_t linear{};
+};
+
+namespace tree_hash_detail
+{
+
+using digest_t = sha256_t::message_digest_t;
+
+// Node is hashed as a message of fixed length, i.e. two concatenated digests.
+inline digest_t combine(const digest_t& left, const digest_t& right)
+{
+    std::array<uint8_t, 2 * sha256_t::digest_size_k> node;
+    std::copy(left.begin(), left.end(), node.begin());
+    std::copy(right.begin(), right.end(), node.begin() + sha256_t::digest_size_k);
+    return hash_fixed<sha256_t, 2 * sha256_t::digest_size_k>(node);
+}
+
+}
+
+// Combines digests of chunks into the root of the tree, level by level.
+inline sha256_t::message_digest_t tree_hash_root(std::span<const sha256_t::message_digest_t> chunks)
+{
+    assert(!chunks.empty());
+
+    std::vector<sha256_t::message_digest_t> level(chunks.begin(), chunks.end());
+    while (level.size() > 1)
+    {
+        for (size_t i = 0; i < level.size() / 2; ++i)
+        {
+            level[i] = tree_hash_detail::combine(level[2 * i], level[2 * i + 1]);
+        }
+        if (level.size() % 2 != 0)
+        {
+            level[level.size() / 2] = level.back();
+        }
+        level.resize((level.size() + 1) / 2);
+    }
+    return level.front();
+}
+
+// Evaluates the tree hash of a message appended in blocks of arbitrary length, optionally together with its
+// linear SHA-256. Appended data is copied into a window of chunk buffers, so that complete chunks accumulate across
+// calls of update() (e.g. 1 MiB blocks read from a file) and are hashed in the background by persistent worker
+// threads, each taking as many chunks as there are SIMD lanes. Linear digest is evaluated by one more thread from
+// the same buffers. The window holds (threads + 1) × lanes chunks; update() waits only if all of them are in use.
+// Instead of keeping digests of all chunks, complete subtrees are combined as soon as they are available (a binary
+// counter of subtrees), which gives the same root as combining level by level.
+class tree_hasher_t
+{
+public:
+    explicit tree_hasher_t(size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1), bool linear = true)
+        : linear_m{ linear }
+        , lanes_m{ batch_lanes<sha256_t>(batch_kernel<sha256_t>()) }
+        , window_m((std::max<size_t>(threads, 1) + 1) * lanes_m)
+    {
+        for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i)
+        {
+            workers_m.emplace_back([this] { hash_leaves(); });
+        }
+        if (linear_m)
+        {
+            workers_m.emplace_back([this] { hash_linear(); });
+        }
+    }
+
+    tree_hasher_t(const tree_hasher_t&) = delete;
+    tree_hasher_t& operator=(const tree_hasher_t&) = delete;
+
+    ~tree_hasher_t()
+    {
+        {
+            std::lock_guard lock{ mutex_m };
+            stopping_m = true;
+        }
+        work_m.notify_all();
+        for (auto& worker : workers_m)
+        {
+            worker.join();
+        }
+    }
+
+    void update(const char* input, size_t length)
+    {
+        assert(!finalized_m);
+
+        while (length > 0)
+        {
+            auto& chunk = acquire();
+            const auto count = std::min(length, tree_hash_chunk_size_k - chunk.size);
+            std::copy(input, input + count, chunk.data.get() + chunk.size);
+            chunk.size += count;
+            input += count;
+            length -= count;
+            if (chunk.size == tree_hash_chunk_size_k)
+            {
+                submit();
+            }
+        }
+    }
+
+    void update(std::string_view input)
+    {
+        update(input.data(), input.size());
+    }
+
+    // Once finalized, no more data can be appended and each subsequent call returns the same result. Tree hash of
+    // an empty message is the digest of an empty chunk.
+    tree_hash_t finalize()
+    {
+        if (!finalized_m)
+        {
+            if (filling_m || filled_m == 0)
+            {
+                acquire();
+                submit();
+            }
+            std::unique_lock lock{ mutex_m };
+            flushing_m = true;
+            work_m.notify_all();
+            progress_m.wait(lock, [this] { return retire() == filled_m; });
+
+            while (subtrees_m.size() > 1)
+            {
+                const auto right = subtrees_m.back();
+                subtrees_m.pop_back();
+                subtrees_m.back() = tree_hash_detail::combine(subtrees_m.back(), right);
+            }
+            result_m.tree = subtrees_m.front();
+            if (linear_m)
+            {
+                result_m.linear = linear_hasher_m.finalize();
+            }
+            finalized_m = true;
+        }
+        return result_m;
+    }
+
+private:
+    using digest_t = sha256_t::message_digest_t;
+
+    struct chunk_t
+    {
+        std::unique_ptr<char[]> data;
+        size_t size{ 0 };
+        digest_t digest{};
+        bool hashed{ false };
+    };
+
+    const bool linear_m;
+    const size_t lanes_m;
+    // Chunk with sequence number n is kept in window_m[n % window_m.size()].
+    std::vector<chunk_t> window_m;
+    std::vector<std::thread> workers_m;
+
+    // Sequence numbers of chunks are guarded by the mutex: chunks before filled_m are complete, those before
+    // claimed_m are taken by the workers, those before linear_position_m appended to the linear hasher and those
+    // before retired_m pushed to subtrees, so that their buffers can be reused.
+    std::mutex mutex_m;
+    // Workers wait for complete chunks, the owner for the chunks to be hashed.
+    std::condition_variable work_m;
+    std::condition_variable progress_m;
+    uint64_t filled_m{ 0 };
+    uint64_t claimed_m{ 0 };
+    uint64_t linear_position_m{ 0 };
+    uint64_t retired_m{ 0 };
+    bool flushing_m{ false };
+    bool stopping_m{ false };
+
+    // Accessed by the owner only: the chunk being filled is not visible to the workers until it is submitted.
+    bool filling_m{ false };
+    sha256_t linear_hasher_m;
+    // Roots of complete subtrees of decreasing size; subtree sizes correspond to set bits of the number of chunks.
+    std::vector<digest_t> subtrees_m;
+    tree_hash_t result_m;
+    bool finalized_m{ false };
+
+    chunk_t& slot(uint64_t sequence)
+    {
+        return window_m[sequence % window_m.size()];
+    }
+
+    // Returns the chunk being filled, waiting for a free buffer if a new chunk is started.
+    chunk_t& acquire()
+    {
+        if (!filling_m)
+        {
+            std::unique_lock lock{ mutex_m };
+            progress_m.wait(lock, [this] { return filled_m - retire() < window_m.size(); });
+            auto& chunk = slot(filled_m);
+            if (!chunk.data)
+            {
+                chunk.data = std::make_unique_for_overwrite<char[]>(tree_hash_chunk_size_k);
+            }
+            chunk.size = 0;
+            filling_m = true;
+        }
+        return slot(filled_m);
+    }
+
+    void submit()
+    {
+        {
+            std::lock_guard lock{ mutex_m };
+            ++filled_m;
+        }
+        filling_m = false;
+        work_m.notify_all();
+    }
+
+    // Pushes digests of chunks hashed by all workers in the order of chunks. Called by the owner with the mutex
+    // held; returns the number of retired chunks.
+    uint64_t retire()
+    {
+        while (retired_m < filled_m && slot(retired_m).hashed && (!linear_m || retired_m < linear_position_m))
+        {
+            auto& chunk = slot(retired_m);
+            chunk.hashed = false;
+            push(chunk.digest);
+            ++retired_m;
+        }
+        return retired_m;
+    }
+
+    void push(const digest_t& digest)
+    {
+        subtrees_m.push_back(digest);
+        for (auto count = retired_m + 1; count % 2 == 0; count /= 2)
+        {
+            const auto right = subtrees_m.back();
+            subtrees_m.pop_back();
+            subtrees_m.back() = tree_hash_detail::combine(subtrees_m.back(), right);
+        }
+    }
+
+    // Each worker takes complete chunks for all SIMD lanes, or the remaining ones once the hasher is finalized.
+    void hash_leaves()
+    {
+        std::vector<std::string_view> messages;
+        std::vector<digest_t> digests;
+        std::unique_lock lock{ mutex_m };
+        while (true)
+        {
+            work_m.wait(lock, [this] { return stopping_m || filled_m - claimed_m >= lanes_m || (flushing_m && filled_m > claimed_m); });
+            if (stopping_m)
+            {
+                return;
+            }
+            const auto first = claimed_m;
+            const auto count = std::min<uint64_t>(filled_m - claimed_m, lanes_m);
+            claimed_m += count;
+            messages.clear();
+            for (auto i = first; i < first + count; ++i)
+            {
+                messages.emplace_back(slot(i).data.get(), slot(i).size);
+            }
+            lock.unlock();
+
+            digests.resize(count);
+            hash_batch<sha256_t>(std::span<const std::string_view>{ messages }, std::span{ digests });
+
+            lock.lock();
+            for (size_t i = 0; i < count; ++i)
+            {
+                slot(first + i).digest = digests[i];
+                slot(first + i).hashed = true;
+            }
+            progress_m.notify_one();
+        }
+    }
+
+    void hash_linear()
+    {
+        std::unique_lock lock{ mutex_m };
+        while (true)
+        {
+            work_m.wait(lock, [this] { return stopping_m || linear_position_m < filled_m; });
+            if (stopping_m)
+            {
+                return;
+            }
+            const auto& chunk = slot(linear_position_m);
+            lock.unlock();
+            linear_hasher_m.update(chunk.data.get(), chunk.size);
+            lock.lock();
+            ++linear_position_m;
+            progress_m.notify_one();
+        }
+    }
+};
+
+// Evaluates the tree hash of a message held in memory.
+inline tree_hash_t tree_hash(std::string_view message, size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1), bool linear = true)
+{
+    tree_hasher_t hasher{ threads, linear };
+    hasher.update(message);
+    return hasher.finalize();
+}
+
+}
@@ -29,29 +29,38 @@
 
 #pragma once
 
+#include <bit>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
 
 namespace jsribar::cryptography::sha2
 {
 
+// Element types of ranges that can be hashed directly: characters and bytes.
 template <typename T>
-constexpr T to_uint(const uint8_t* input)
+concept byte_like = sizeof(T) == 1 && ((std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_same_v<T, std::byte>);
+
+// Bytes are combined in a single fold expression which is considerably cheaper to evaluate at compile time than a loop.
+// Input can be a char array, too, so that string literals need not be copied to a byte buffer first.
+template <typename T, typename Byte, size_t... i>
+constexpr T to_uint(const Byte* input, std::index_sequence<i...>)
 {
-    T result = 0;
-    for (size_t i = 0; i < sizeof(T); ++i)
-    {
-        result <<= 8;
-        result += *input;
-        ++input;
-    }
-    return result;
+    return T(((T(uint8_t(input[i])) << (8 * (sizeof(T) - 1 - i))) | ...));
 }
 
-template <>
-constexpr uint8_t to_uint<uint8_t>(const uint8_t* input)
+template <typename T, typename Byte>
+constexpr T to_uint(const Byte* input)
 {
-    return *input;
+    static_assert(sizeof(Byte) == 1);
+    return to_uint<T>(input, std::make_index_sequence<sizeof(T)>{});
 }
 
 
@@ -99,6 +108,78 @@ constexpr void to_uint8_array<uint8_t>(uint8_t value, uint8_t* dest, int length)
 }
 
 
+template <typename T>
+constexpr T byte_swap(T value)
+{
+    if (!std::is_constant_evaluated())
+    {
+#if defined(_MSC_VER)
+        if constexpr (sizeof(T) == 4)
+        {
+            return T(_byteswap_ulong(value));
+        }
+        else if constexpr (sizeof(T) == 8)
+        {
+            return T(_byteswap_uint64(value));
+        }
+#else
+        if constexpr (sizeof(T) == 4)
+        {
+            return T(__builtin_bswap32(value));
+        }
+        else if constexpr (sizeof(T) == 8)
+        {
+            return T(__builtin_bswap64(value));
+        }
+#endif
+    }
+
+    T result = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        result = T(result << 8) | T(value & 0xFF);
+        value >>= 8;
+    }
+    return result;
+}
+
+// Reads big-endian word. At runtime the word is loaded at once and bytes are swapped if needed.
+template <typename T>
+constexpr T load_big_endian(const uint8_t* input)
+{
+    if (std::is_constant_evaluated())
+    {
+        return to_uint<T>(input);
+    }
+
+    T value;
+    std::memcpy(&value, input, sizeof(T));
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        value = byte_swap(value);
+    }
+    return value;
+}
+
+
+// Writes big-endian word. At runtime bytes are swapped if needed and the word is stored at once.
+template <typename T>
+constexpr void store_big_endian(T value, uint8_t* output)
+{
+    if (std::is_constant_evaluated())
+    {
+        to_uint8_array(value, output);
+        return;
+    }
+
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        value = byte_swap(value);
+    }
+    std::memcpy(output, &value, sizeof(T));
+}
+
+
 template <typename T>
 constexpr T right_rotate(const T input, size_t n)
 {
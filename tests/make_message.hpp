@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 by Julijan Šribar
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Byte i of a test message. The pattern repeats only every 251 * 65536 bytes, so that blocks and chunks of long
+// messages differ from each other; messages with different seeds differ at every position.
+constexpr char message_byte(size_t i, size_t seed = 0)
+{
+    return char((i * 131 + seed * 61 + i / 65536) % 251);
+}
+
+inline std::string make_message(size_t length, size_t seed = 0)
+{
+    std::string message(length, '\0');
+    for (size_t i = 0; i < length; ++i)
+    {
+        message[i] = message_byte(i, seed);
+    }
+    return message;
+}
+
+template <size_t N>
+constexpr std::array<uint8_t, N> make_message()
+{
+    std::array<uint8_t, N> message{};
+    for (size_t i = 0; i < N; ++i)
+    {
+        message[i] = uint8_t(message_byte(i));
+    }
+    return message;
+}
+
+// Messages of different lengths below 300 bytes and with different content, so that lanes of multi-buffer kernels
+// are retired and refilled at different times.
+inline std::vector<std::string> make_messages(size_t count)
+{
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < count; ++i)
+    {
+        messages.push_back(make_message((i * 37 + i * i * 11) % 300, i));
+    }
+    return messages;
+}
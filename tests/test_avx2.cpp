@@ -0,0 +1,80 @@
+#include <catch2/catch.hpp>
+
+#include <sha2.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+#if JSRIBAR_SHA2_X86
+
+namespace
+{
+
+constexpr std::string_view message_k{ "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ" };
+
+bool avx2_supported()
+{
+    return cpu_features().avx2 && cpu_features().bmi2;
+}
+
+// Message lengths around message block boundaries, so that messages are padded into 1 to 4 blocks.
+constexpr std::array<size_t, 16> lengths_k{ 0, 1, 55, 56, 63, 64, 111, 112, 119, 127, 128, 129, 239, 240, 255, 372 };
+
+template <typename Sha, size_t... i>
+constexpr auto prefix_digests(std::index_sequence<i...>)
+{
+    return std::array{ Sha{ message_k.substr(0, lengths_k[i]) }.digest()... };
+}
+
+// Pads the message and compresses all its blocks with a single kernel call.
+template <typename Sha>
+typename Sha::message_digest_t avx2_digest(std::string_view message)
+{
+    using T = typename Sha::word_t;
+    constexpr auto block_size = Sha::message_block_size_k;
+
+    const auto count = (message.size() + 1 + 2 * sizeof(T) + block_size - 1) / block_size;
+    std::vector<uint8_t> blocks(count * block_size, 0);
+    std::copy(message.begin(), message.end(), blocks.begin());
+    blocks[message.size()] = 0x80;
+    to_uint8_array(uint64_t(message.size() * 8), blocks.data() + blocks.size() - 8);
+
+    auto h = Sha::initial_hash_values_t::values;
+    avx2::compress<typename Sha::round_constants_t>(h, blocks.data(), count);
+
+    typename Sha::message_digest_t digest;
+    for (size_t i = 0; i * sizeof(T) < digest.size(); ++i)
+    {
+        to_uint8_array(h[i], digest.data() + i * sizeof(T), int(std::min(sizeof(T), digest.size() - i * sizeof(T))));
+    }
+    return digest;
+}
+
+template <typename Sha>
+void check_prefix_digests()
+{
+    static constexpr auto expected = prefix_digests<Sha>(std::make_index_sequence<lengths_k.size()>{});
+
+    for (size_t i = 0; i < lengths_k.size(); ++i)
+    {
+        INFO("Message length: " << lengths_k[i]);
+        REQUIRE(avx2_digest<Sha>(message_k.substr(0, lengths_k[i])) == expected[i]);
+    }
+}
+
+}
+
+TEMPLATE_TEST_CASE("AVX2 implementation gives the same digests as compile time evaluation", "[AVX2]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    if (!avx2_supported())
+    {
+        WARN("AVX2 or BMI2 is not supported by CPU");
+        return;
+    }
+
+    check_prefix_digests<TestType>();
+}
+
+#endif
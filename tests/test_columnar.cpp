@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+
+#include <columnar.hpp>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+// Column of rows of lengths 0 to 300, so that rows span zero to five message blocks.
+template <typename Offset>
+struct column_t
+{
+    std::string data;
+    std::vector<Offset> offsets{ 0 };
+
+    explicit column_t(size_t rows)
+    {
+        for (size_t i = 0; i < rows; ++i)
+        {
+            const auto length = (i * 97) % 301;
+            for (size_t j = 0; j < length; ++j)
+            {
+                data.push_back(char(i + j * 31));
+            }
+            offsets.push_back(Offset(data.size()));
+        }
+    }
+};
+
+template <typename Sha, typename Offset>
+void check_column(size_t rows, size_t threads)
+{
+    INFO("Rows: " << rows << ", threads: " << threads);
+    const column_t<Offset> column{ rows };
+    std::vector<typename Sha::message_digest_t> digests(rows);
+    hash_column<Sha>(column.data.data(), std::span<const Offset>{ column.offsets }, std::span{ digests }, threads);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        const Sha sha{ column.data.data() + column.offsets[i], size_t(column.offsets[i + 1] - column.offsets[i]) };
+        REQUIRE(digests[i] == sha.digest());
+    }
+}
+
+}
+
+TEMPLATE_TEST_CASE("Digests of a column match digests of its rows", "[columnar]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    check_column<TestType, int32_t>(0, 1);
+    check_column<TestType, int32_t>(1, 1);
+    check_column<TestType, int32_t>(2500, 1);
+    check_column<TestType, int64_t>(2500, 1);
+}
+
+TEST_CASE("Column split across threads", "[columnar]")
+{
+    check_column<sha256_t, int64_t>(5, 4);
+    check_column<sha256_t, int64_t>(2500, 2);
+    check_column<sha512_t, int32_t>(5000, 3);
+    check_column<sha512_t, int32_t>(5000, 16);
+}
@@ -0,0 +1,142 @@
+#include <catch2/catch.hpp>
+
+#include <multi_buffer.hpp>
+#include <sha2.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+constexpr std::string_view message_k{ "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ" };
+
+// Restores automatic kernel selection when test case ends.
+struct forced_kernel_guard_t
+{
+    explicit forced_kernel_guard_t(kernel_t kernel)
+    {
+        force_kernel(kernel);
+    }
+
+    ~forced_kernel_guard_t()
+    {
+        force_kernel(std::nullopt);
+    }
+};
+
+template <typename Sha>
+void check_digest()
+{
+    static constexpr auto expected = Sha{ message_k }.digest();
+
+    const std::string input{ message_k };
+    REQUIRE(Sha{ input.data(), input.size() }.digest() == expected);
+}
+
+}
+
+TEST_CASE("Kernel names are converted to kernels and back", "[dispatch]")
+{
+    for (auto kernel : { kernel_t::portable, kernel_t::sha_ni, kernel_t::avx2, kernel_t::avx512 })
+    {
+        REQUIRE(kernel_from_name(kernel_name(kernel)) == kernel);
+    }
+    REQUIRE_FALSE(kernel_from_name("sse2").has_value());
+}
+
+TEST_CASE("Automatically selected kernel is supported by CPU", "[dispatch]")
+{
+    force_kernel(std::nullopt);
+
+    REQUIRE(kernel_supported(sha256_t::kernel()));
+    REQUIRE(kernel_supported(sha512_t::kernel()));
+    REQUIRE(sha512_t::kernel() == (kernel_supported(kernel_t::avx2) ? kernel_t::avx2 : kernel_t::portable));
+    REQUIRE(kernel_supported(batch_kernel<sha256_t>()));
+    REQUIRE(kernel_supported(batch_kernel<sha512_t>()));
+    if (kernel_supported(kernel_t::sha_ni) && !kernel_supported(kernel_t::avx512))
+    {
+        REQUIRE(batch_kernel<sha256_t>() == kernel_t::sha_ni);
+    }
+}
+
+TEMPLATE_TEST_CASE("Forced portable kernel gives the same digests as compile time evaluation", "[dispatch]", sha224_t, sha256_t, sha384_t, sha512_t)
+{
+    forced_kernel_guard_t guard{ kernel_t::portable };
+
+    REQUIRE(TestType::kernel() == kernel_t::portable);
+    REQUIRE(batch_kernel<TestType>() == kernel_t::portable);
+    check_digest<TestType>();
+}
+
+TEMPLATE_TEST_CASE("Forced AVX2 kernel gives the same digests as compile time evaluation", "[dispatch]", sha224_t, sha256_t, sha384_t, sha512_t)
+{
+    if (!kernel_supported(kernel_t::avx2))
+    {
+        WARN("AVX2 or BMI2 is not supported by CPU");
+        return;
+    }
+
+    forced_kernel_guard_t guard{ kernel_t::avx2 };
+
+    REQUIRE(TestType::kernel() == kernel_t::avx2);
+    check_digest<TestType>();
+}
+
+TEMPLATE_TEST_CASE("Forced AVX2 kernel is used for batches", "[dispatch]", sha224_t, sha256_t, sha384_t, sha512_t)
+{
+    if (!kernel_supported(kernel_t::avx2))
+    {
+        WARN("AVX2 or BMI2 is not supported by CPU");
+        return;
+    }
+
+    forced_kernel_guard_t guard{ kernel_t::avx2 };
+
+    REQUIRE(batch_kernel<TestType>() == kernel_t::avx2);
+    const std::vector<std::string_view> messages(9, message_k);
+    std::vector<typename TestType::message_digest_t> digests(messages.size());
+    hash_batch<TestType>(std::span{ messages }, std::span{ digests });
+    for (const auto& digest : digests)
+    {
+        REQUIRE(digest == TestType{ message_k }.digest());
+    }
+}
+
+TEST_CASE("Forced kernel not supported by algorithm falls back to automatic selection", "[dispatch]")
+{
+    force_kernel(std::nullopt);
+    const auto automatic = sha512_t::kernel();
+
+    forced_kernel_guard_t guard{ kernel_t::sha_ni };
+
+    REQUIRE(sha512_t::kernel() == automatic);
+    check_digest<sha512_t>();
+}
+
+TEST_CASE("Kernel bound while forced kernel changes is the last forced kernel", "[dispatch]")
+{
+    const auto last = kernel_supported(kernel_t::avx2) ? kernel_t::avx2 : kernel_t::portable;
+    std::atomic<bool> forcing{ true };
+    std::thread hashing{ [&]
+        {
+            while (forcing.load())
+            {
+                check_digest<sha256_t>();
+            }
+        } };
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        force_kernel(i % 2 == 0 ? kernel_t::portable : last);
+    }
+    force_kernel(last);
+    forcing.store(false);
+    hashing.join();
+
+    REQUIRE(sha256_t::kernel() == last);
+    force_kernel(std::nullopt);
+}
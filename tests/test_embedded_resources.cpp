@@ -0,0 +1,39 @@
+#include <catch2/catch.hpp>
+
+// Generated by jsribar_sha2_embed_resources() (see tests/CMakeLists.txt); the header itself checks the digests
+// of the fixtures against digests evaluated by CMake.
+#include <embedded_sha256.hpp>
+#include <embedded_sha512.hpp>
+
+#include <cstdint>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+template <typename Sha, typename Resource>
+typename Sha::message_digest_t runtime_digest(const Resource& resource)
+{
+    return Sha{ reinterpret_cast<const char*>(resource.data()), resource.size() }.digest();
+}
+
+}
+
+TEST_CASE("Embedded resources contain the fixture files", "[resource]")
+{
+    REQUIRE(fixtures_sha256::fox_txt.size() == 44);
+    REQUIRE(fixtures_sha256::fox_txt.front() == uint8_t('T'));
+    REQUIRE(fixtures_sha256::fox_txt.back() == uint8_t('\n'));
+    REQUIRE(fixtures_sha256::binary_bin.size() == 5000);
+    REQUIRE(fixtures_sha512::binary_bin == fixtures_sha256::binary_bin);
+}
+
+TEST_CASE("Digests of embedded resources match the hasher", "[resource]")
+{
+    STATIC_REQUIRE(fixtures_sha256::fox_txt_digest == sha256_of<fixtures_sha256::fox_txt>);
+    CHECK(fixtures_sha256::fox_txt_digest == runtime_digest<sha256_t>(fixtures_sha256::fox_txt));
+    CHECK(fixtures_sha256::binary_bin_digest == runtime_digest<sha256_t>(fixtures_sha256::binary_bin));
+    CHECK(fixtures_sha512::fox_txt_digest == runtime_digest<sha512_t>(fixtures_sha512::fox_txt));
+    CHECK(fixtures_sha512::binary_bin_digest == runtime_digest<sha512_t>(fixtures_sha512::binary_bin));
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch.hpp>
+
+#include <file_hash.hpp>
+#include <tree_hash.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+// Temporary file removed on destruction.
+struct temp_file_t
+{
+    std::filesystem::path path;
+    std::string content;
+
+    explicit temp_file_t(size_t size)
+        : path{ std::filesystem::temp_directory_path() / ("jsribar_sha2_file_hash_" + std::to_string(::getpid()) + "_" + std::to_string(size)) }
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            content.push_back(char((i * 131 + i / 4096) % 251));
+        }
+        std::ofstream{ path, std::ios::binary }.write(content.data(), std::streamsize(content.size()));
+    }
+
+    ~temp_file_t()
+    {
+        std::filesystem::remove(path);
+    }
+};
+
+std::vector<file_reader_t> readers()
+{
+    std::vector<file_reader_t> readers{ file_reader_t::automatic, file_reader_t::pread };
+    if (io_uring_available())
+    {
+        readers.push_back(file_reader_t::io_uring);
+    }
+    return readers;
+}
+
+}
+
+TEMPLATE_TEST_CASE("Digest of file equals digest of its content", "[file hash]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    for (const size_t size : { 0, 1, 4095, 4096, 3 * 4096, 3 * 4096 + 1, 10 * 4096 + 123 })
+    {
+        const temp_file_t file{ size };
+        const TestType expected{ file.content };
+        for (const auto reader : readers())
+        {
+            for (const size_t buffers : { 1, 2, 5 })
+            {
+                for (const bool direct : { false, true })
+                {
+                    const auto result = hash_file<TestType>(file.path.c_str(), { reader, 3 * 4096, buffers, direct });
+                    REQUIRE_FALSE(result.error);
+                    CHECK(result.digest == expected.digest());
+                    CHECK(result.timing.bytes == size);
+                    CHECK(result.timing.reader != file_reader_t::automatic);
+                    if (reader != file_reader_t::automatic)
+                    {
+                        CHECK(result.timing.reader == reader);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Buffer size is rounded up to multiple of 4096 bytes", "[file hash]")
+{
+    const temp_file_t file{ 100000 };
+    const sha256_t expected{ file.content };
+    for (const size_t buffer_size : { 0, 1, 5000 })
+    {
+        const auto result = hash_file<sha256_t>(file.path.c_str(), { file_reader_t::automatic, buffer_size, 3 });
+        REQUIRE_FALSE(result.error);
+        CHECK(result.digest == expected.digest());
+    }
+}
+
+TEST_CASE("Timing of stages does not exceed total time", "[file hash]")
+{
+    const temp_file_t file{ 1 << 20 };
+    for (const auto reader : readers())
+    {
+        const auto result = hash_file<sha256_t>(file.path.c_str(), { reader, 1 << 16 });
+        REQUIRE_FALSE(result.error);
+        CHECK(result.timing.hash > std::chrono::nanoseconds::zero());
+        CHECK(result.timing.wait + result.timing.hash <= result.timing.total);
+    }
+}
+
+TEST_CASE("Errors are reported for missing files and directories", "[file hash]")
+{
+    for (const auto reader : readers())
+    {
+        const auto missing = hash_file<sha256_t>("/nonexistent/jsribar_sha2_file", { reader });
+        CHECK(missing.error == std::errc::no_such_file_or_directory);
+        const auto directory = hash_file<sha256_t>(std::filesystem::temp_directory_path().c_str(), { reader });
+        CHECK(directory.error == std::errc::invalid_argument);
+    }
+}
+
+TEST_CASE("File is appended to tree hasher", "[file hash]")
+{
+    const temp_file_t file{ 5 * tree_hash_chunk_size_k + 1000 };
+    const auto expected = tree_hash(file.content, 2);
+    for (const auto reader : readers())
+    {
+        tree_hasher_t hasher{ 2 };
+        file_hash_timing_t timing;
+        REQUIRE_FALSE(update_from_file(hasher, file.path.c_str(), timing, { reader, 2 * tree_hash_chunk_size_k, 2 }));
+        CHECK(timing.bytes == file.content.size());
+        const auto result = hasher.finalize();
+        CHECK(result.tree == expected.tree);
+        CHECK(result.linear == expected.linear);
+    }
+}
@@ -0,0 +1,85 @@
+#include <catch2/catch.hpp>
+
+#include <dispatch.hpp>
+#include <fixed_length.hpp>
+
+#include "hex_to_binary.hpp"
+#include "make_message.hpp"
+
+#include <array>
+#include <optional>
+#include <string_view>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+template <typename Sha, size_t N>
+void check_fixed_length()
+{
+    INFO("Message length: " << N);
+    constexpr auto message = make_message<N>();
+    const Sha sha{ reinterpret_cast<const char*>(message.data()), message.size() };
+    REQUIRE(hash_fixed<Sha>(message) == sha.digest());
+}
+
+// Lengths cover empty message, digest sizes, block boundaries of both word sizes and multiple blocks.
+template <typename Sha>
+void check_fixed_lengths()
+{
+    check_fixed_length<Sha, 0>();
+    check_fixed_length<Sha, 1>();
+    check_fixed_length<Sha, 32>();
+    check_fixed_length<Sha, 55>();
+    check_fixed_length<Sha, 56>();
+    check_fixed_length<Sha, 64>();
+    check_fixed_length<Sha, 100>();
+    check_fixed_length<Sha, 111>();
+    check_fixed_length<Sha, 112>();
+    check_fixed_length<Sha, 128>();
+    check_fixed_length<Sha, 256>();
+}
+
+}
+
+TEMPLATE_TEST_CASE("Fixed length hashing gives the same digest as hasher", "[fixed length]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    check_fixed_lengths<TestType>();
+}
+
+TEST_CASE("Fixed length hashing gives the same digest with all kernels", "[fixed length]")
+{
+    for (auto kernel : { kernel_t::portable, kernel_t::sha_ni, kernel_t::avx2, kernel_t::avx512 })
+    {
+        INFO("Kernel: " << kernel_name(kernel));
+        force_kernel(kernel);
+        check_fixed_lengths<sha256_t>();
+        check_fixed_lengths<sha512_t>();
+    }
+    force_kernel(std::nullopt);
+}
+
+TEST_CASE("Compile time evaluation of fixed length hashing", "[fixed length]")
+{
+    SECTION("SHA-256 of 32 zero bytes")
+    {
+        constexpr auto hex_to_binary = hex_to_binary_fun<32>;
+        STATIC_REQUIRE(hash_fixed<sha256_t>(std::array<uint8_t, 32>{}) == hex_to_binary("66687aadf862bd776c8fc18b8e9f8e20089714856ee233b3902a591d0d5f2925"));
+    }
+
+    SECTION("SHA-512 of 128 zero bytes")
+    {
+        constexpr auto hex_to_binary = hex_to_binary_fun<64>;
+        STATIC_REQUIRE(hash_fixed<sha512_t>(std::array<uint8_t, 128>{}) == hex_to_binary("ab942f526272e456ed68a979f50202905ca903a141ed98443567b11ef0bf25a552d639051a01be58558122c58e3de07d749ee59ded36acf0c55cd91924d6ba11"));
+    }
+}
+
+TEST_CASE("Double SHA-256", "[fixed length]")
+{
+    constexpr auto hex_to_binary = hex_to_binary_fun<32>;
+
+    STATIC_REQUIRE(sha256d("abc") == hex_to_binary("4f8b42c22dd3729b519ba6f68d2da7cc5b2d606d05daed5ad5128cc03e6c6358"));
+    REQUIRE(sha256d("abc") == hex_to_binary("4f8b42c22dd3729b519ba6f68d2da7cc5b2d606d05daed5ad5128cc03e6c6358"));
+    REQUIRE(sha256d(std::array<uint8_t, 32>{}) == hex_to_binary("2b32db6c2c0a6235fb1397e8225ea85e0f0e6e8c7b126d0016ccbde0e667151e"));
+}
@@ -0,0 +1,133 @@
+#include <catch2/catch.hpp>
+
+#include <frozen_map.hpp>
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+constexpr auto colors_k = make_frozen_map<sha256_t, int>({ { "red", 0xff0000 }, { "green", 0x00ff00 }, { "blue", 0x0000ff } });
+
+struct generated_key_t
+{
+    std::array<char, 8> characters{};
+    size_t length{ 0 };
+
+    constexpr std::string_view view() const
+    {
+        return { characters.data(), length };
+    }
+};
+
+// Keys "key0" to "key<N-1>", stored in a constant table so that views of them can be used at compile time.
+template <size_t N>
+constexpr auto generated_keys_k = []
+{
+    std::array<generated_key_t, N> keys{};
+    for (size_t i = 0; i < N; ++i)
+    {
+        auto& key = keys[i];
+        key.characters = { 'k', 'e', 'y' };
+        key.length = 3;
+        for (size_t divisor = 1000; divisor > 0; divisor /= 10)
+        {
+            if (i >= divisor || divisor == 1)
+            {
+                key.characters[key.length++] = char('0' + i / divisor % 10);
+            }
+        }
+    }
+    return keys;
+}();
+
+template <size_t N>
+constexpr std::array<std::pair<std::string_view, size_t>, N> generated_entries()
+{
+    std::array<std::pair<std::string_view, size_t>, N> entries{};
+    for (size_t i = 0; i < N; ++i)
+    {
+        entries[i] = { generated_keys_k<N>[i].view(), i };
+    }
+    return entries;
+}
+
+template <typename Sha, size_t N, size_t FingerprintSize>
+void check_generated_map()
+{
+    INFO("Keys: " << N << ", fingerprint size: " << FingerprintSize);
+    const auto map = make_frozen_map<Sha, size_t, FingerprintSize>(generated_entries<N>());
+    for (size_t i = 0; i < N; ++i)
+    {
+        const auto value = map.find(generated_keys_k<N>[i].view());
+        REQUIRE(value != nullptr);
+        REQUIRE(*value == i);
+    }
+    // Absent keys match a single byte fingerprint with probability 1/256.
+    if constexpr (FingerprintSize >= 8)
+    {
+        REQUIRE_FALSE(map.contains("key"));
+        REQUIRE_FALSE(map.contains("missing"));
+        REQUIRE_FALSE(map.contains(std::to_string(N)));
+    }
+}
+
+}
+
+TEST_CASE("Frozen map finds values of its keys", "[frozen map]")
+{
+    REQUIRE(colors_k.size() == 3);
+    REQUIRE(*colors_k.find("red") == 0xff0000);
+    REQUIRE(*colors_k.find("green") == 0x00ff00);
+    REQUIRE(*colors_k.find("blue") == 0x0000ff);
+    REQUIRE(*colors_k.find(sha256("blue")) == 0x0000ff);
+    REQUIRE(colors_k.find("black") == nullptr);
+    REQUIRE(colors_k.find("") == nullptr);
+    REQUIRE_FALSE(colors_k.contains("Red"));
+}
+
+TEST_CASE("Compile time evaluation of frozen map lookups", "[frozen map]")
+{
+    STATIC_REQUIRE(*colors_k.find("green") == 0x00ff00);
+    STATIC_REQUIRE(colors_k.find("yellow") == nullptr);
+
+    constexpr auto set = make_frozen_set<sha512_t, 8>({ "GET", "POST", "PUT", "DELETE" });
+    STATIC_REQUIRE(set.contains("POST"));
+    STATIC_REQUIRE_FALSE(set.contains("PATCH"));
+}
+
+TEMPLATE_TEST_CASE("Frozen map of generated keys", "[frozen map]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    check_generated_map<TestType, 1, TestType::digest_size_k>();
+    check_generated_map<TestType, 2, TestType::digest_size_k>();
+    check_generated_map<TestType, 17, TestType::digest_size_k>();
+    check_generated_map<TestType, 64, 8>();
+    check_generated_map<TestType, 1000, 8>();
+    check_generated_map<TestType, 1000, 1>();
+}
+
+TEST_CASE("Frozen set contains its keys only", "[frozen map]")
+{
+    const auto set = make_frozen_set<sha256_t>({ "alpha", "beta", "gamma", "delta", "epsilon" });
+    for (std::string_view key : { "alpha", "beta", "gamma", "delta", "epsilon" })
+    {
+        REQUIRE(set.contains(key));
+    }
+    for (std::string_view key : { "zeta", "eta", "theta", "Alpha", "" })
+    {
+        REQUIRE_FALSE(set.contains(key));
+    }
+}
+
+TEST_CASE("Frozen map with duplicate keys cannot be built", "[frozen map]")
+{
+    REQUIRE_THROWS_AS((make_frozen_map<sha256_t, int>({ { "red", 1 }, { "green", 2 }, { "red", 3 } })), std::invalid_argument);
+    REQUIRE_THROWS_AS(make_frozen_set<sha256_t>({ "a", "b", "c", "d", "a" }), std::invalid_argument);
+}
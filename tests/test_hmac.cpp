@@ -0,0 +1,137 @@
+#include <catch2/catch.hpp>
+
+#include <hmac.hpp>
+
+#include "hex_to_binary.hpp"
+#include "make_message.hpp"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+// Test cases 1, 2 and 6 from RFC 4231. SHA-512/224 and SHA-512/256 values were evaluated with OpenSSL.
+const std::string key_1(20, '\x0b');
+constexpr std::string_view message_1{ "Hi There" };
+constexpr std::string_view key_2{ "Jefe" };
+constexpr std::string_view message_2{ "what do ya want for nothing?" };
+const std::string key_6(131, '\xaa');
+constexpr std::string_view message_6{ "Test Using Larger Than Block-Size Key - Hash Key First" };
+
+template <typename Sha>
+std::array<std::string_view, 3> expected_macs()
+{
+    if constexpr (std::is_same_v<Sha, sha224_t>)
+    {
+        return { "896fb1128abbdf196832107cd49df33f47b4b1169912ba4f53684b22", "a30e01098bc6dbbf45690f3a7e9e6d0f8bbea2a39e6148008fd05e44", "95e9a0db962095adaebe9b2d6f0dbce2d499f112f2d2b7273fa6870e" };
+    }
+    else if constexpr (std::is_same_v<Sha, sha256_t>)
+    {
+        return { "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7", "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54" };
+    }
+    else if constexpr (std::is_same_v<Sha, sha384_t>)
+    {
+        return { "afd03944d84895626b0825f4ab46907f15f9dadbe4101ec682aa034c7cebc59cfaea9ea9076ede7f4af152e8b2fa9cb6", "af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e8e2240ca5e69e2c78b3239ecfab21649", "4ece084485813e9088d2c63a041bc5b44f9ef1012a2b588f3cd11f05033ac4c60c2ef6ab4030fe8296248df163f44952" };
+    }
+    else if constexpr (std::is_same_v<Sha, sha512_t>)
+    {
+        return { "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cdedaa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854", "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737", "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f3526b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598" };
+    }
+    else if constexpr (std::is_same_v<Sha, sha512_224_t>)
+    {
+        return { "b244ba01307c0e7a8ccaad13b1067a4cf6b961fe0c6a20bda3d92039", "4a530b31a79ebcce36916546317c45f247d83241dfb818fd37254bde", "29bef8ce88b54d4226c3c7718ea9e32ace2429026f089e38cea9aeda" };
+    }
+    else
+    {
+        return { "9f9126c3d9c3c330d760425ca8a217e31feae31bfe70196ff81642b868402eab", "6df7b24630d5ccb2ee335407081a87188c221489768fa2020513b2d593359456", "87123c45f7c537a404f8f47cdbedda1fc9bec60eeb971982ce7ef10e774e6539" };
+    }
+}
+
+}
+
+TEMPLATE_TEST_CASE("HMAC of test vectors", "[HMAC]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    constexpr auto hex_to_binary = hex_to_binary_fun<TestType::digest_size_k>;
+    const auto expected = expected_macs<TestType>();
+
+    REQUIRE(hmac_key_t<TestType>{ key_1 }.sign(message_1) == hex_to_binary(expected[0]));
+    REQUIRE(hmac_key_t<TestType>{ key_2 }.sign(message_2) == hex_to_binary(expected[1]));
+    REQUIRE(hmac_key_t<TestType>{ key_6 }.sign(message_6) == hex_to_binary(expected[2]));
+}
+
+TEST_CASE("Compile time evaluation of HMAC", "[HMAC]")
+{
+    SECTION("HMAC-SHA-256")
+    {
+        constexpr auto hex_to_binary = hex_to_binary_fun<32>;
+        static constexpr hmac_key_t<sha256_t> key{ key_2 };
+        STATIC_REQUIRE(key.sign(message_2) == hex_to_binary("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+        REQUIRE(key.verify(message_2, hex_to_binary("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843")));
+    }
+
+    SECTION("HMAC-SHA-512")
+    {
+        constexpr auto hex_to_binary = hex_to_binary_fun<64>;
+        static constexpr hmac_key_t<sha512_t> key{ key_2 };
+        STATIC_REQUIRE(key.sign(message_2) == hex_to_binary("164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737"));
+    }
+}
+
+TEMPLATE_TEST_CASE("HMAC of message appended in chunks gives the same MAC as entire message", "[HMAC]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    const hmac_key_t<TestType> key{ key_6 };
+
+    hmac_t<TestType> mac{ key };
+    mac.update(message_6.substr(0, 10));
+    mac.update(message_6.substr(10));
+    REQUIRE(mac.finalize() == key.sign(message_6));
+    REQUIRE(mac.finalize() == key.sign(message_6));
+}
+
+TEMPLATE_TEST_CASE("HMAC verification rejects modified MAC", "[HMAC]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    const hmac_key_t<TestType> key{ key_1 };
+    auto mac = key.sign(message_1);
+    REQUIRE(key.verify(message_1, mac));
+
+    mac.back() ^= 1;
+    REQUIRE_FALSE(key.verify(message_1, mac));
+    REQUIRE_FALSE(key.verify(message_2, key.sign(message_1)));
+}
+
+TEMPLATE_TEST_CASE("Batch HMAC gives the same MACs as signing each message", "[HMAC]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    const hmac_key_t<TestType> key{ key_2 };
+
+    for (size_t count : { 0, 1, 9, 100 })
+    {
+        const auto messages = make_messages(count);
+        const std::vector<std::string_view> views(messages.begin(), messages.end());
+
+        std::vector<typename TestType::message_digest_t> macs(count);
+        sign_batch(key, views, macs);
+        for (size_t i = 0; i < count; ++i)
+        {
+            REQUIRE(macs[i] == key.sign(messages[i]));
+        }
+
+        const auto results = std::make_unique<bool[]>(count);
+        REQUIRE(verify_batch(key, views, macs, std::span{ results.get(), count }));
+
+        if (count > 0)
+        {
+            macs[count / 2][0] ^= 1;
+            REQUIRE_FALSE(verify_batch(key, views, macs, std::span{ results.get(), count }));
+            for (size_t i = 0; i < count; ++i)
+            {
+                REQUIRE(results[i] == (i != count / 2));
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+
+#include <job_manager.hpp>
+
+#include "make_message.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+TEMPLATE_TEST_CASE("Jobs submitted from many threads are completed with correct digests", "[job manager]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    const auto messages = make_messages(1000);
+    std::vector<typename TestType::message_digest_t> digests(messages.size());
+    std::vector<std::future<typename TestType::message_digest_t>> futures(messages.size());
+    std::atomic<size_t> completed{ 0 };
+    {
+        hash_job_manager_t<TestType> manager{ std::chrono::microseconds{ 20 }, 64 };
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&, t]
+                {
+                    for (size_t i = t; i < messages.size(); i += 4)
+                    {
+                        // Half of the jobs report completion through a callback, the other half through a future.
+                        if (i % 2 == 0)
+                        {
+                            manager.submit(messages[i], [&, i](const auto& digest)
+                                {
+                                    digests[i] = digest;
+                                    ++completed;
+                                });
+                        }
+                        else
+                        {
+                            futures[i] = manager.submit(messages[i]);
+                        }
+                    }
+                });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        for (size_t i = 1; i < messages.size(); i += 2)
+        {
+            digests[i] = futures[i].get();
+        }
+    }
+
+    REQUIRE(completed == messages.size() / 2);
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+        REQUIRE(digests[i] == TestType{ messages[i] }.digest());
+    }
+}
+
+TEST_CASE("Single job is completed when the deadline expires", "[job manager]")
+{
+    hash_job_manager_t<sha256_t> manager{ std::chrono::microseconds{ 100 } };
+    auto future = manager.submit("abc");
+    REQUIRE(future.wait_for(std::chrono::seconds{ 10 }) == std::future_status::ready);
+    REQUIRE(future.get() == sha256("abc"));
+
+    // Manager is idle between jobs.
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+    future = manager.submit("abcd");
+    REQUIRE(future.get() == sha256("abcd"));
+}
+
+TEST_CASE("Pending jobs are completed on destruction", "[job manager]")
+{
+    std::vector<std::future<sha512_t::message_digest_t>> futures;
+    {
+        hash_job_manager_t<sha512_t> manager{ std::chrono::seconds{ 100 } };
+        for (auto message : { "a", "b", "c" })
+        {
+            futures.push_back(manager.submit(message));
+        }
+    }
+    REQUIRE(futures[0].get() == sha512("a"));
+    REQUIRE(futures[1].get() == sha512("b"));
+    REQUIRE(futures[2].get() == sha512("c"));
+}
@@ -0,0 +1,86 @@
+#include <catch2/catch.hpp>
+
+#include <multi_buffer.hpp>
+
+#include "make_message.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+template <typename Sha, typename HashFunction>
+void check_batch(size_t count, HashFunction hash, std::string_view prefix = {})
+{
+    const auto messages = make_messages(count);
+    const std::vector<std::string_view> views(messages.begin(), messages.end());
+    std::vector<typename Sha::message_digest_t> digests(count);
+
+    hash(midstate<Sha>(prefix), std::span{ views }, std::span{ digests });
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        INFO("Message length: " << messages[i].size());
+        REQUIRE(digests[i] == Sha{ std::string{ prefix } + messages[i] }.digest());
+    }
+}
+
+}
+
+TEMPLATE_TEST_CASE("Batch hashing gives the same digests as hashing each message", "[multi-buffer]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    for (size_t count : { 0, 1, 7, 8, 9, 16, 17, 100 })
+    {
+        check_batch<TestType>(count, [](const TestType&, auto messages, auto digests) { hash_batch<TestType>(messages, digests); });
+    }
+}
+
+TEMPLATE_TEST_CASE("Batch hashing from a midstate gives the same digests as hashing prefix with each message", "[multi-buffer]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    const std::string aligned_prefix(2 * TestType::message_block_size_k, 'p');
+    const std::string unaligned_prefix(TestType::message_block_size_k + 5, 'p');
+    for (size_t count : { 0, 1, 9, 100 })
+    {
+        check_batch<TestType>(count, [](const TestType& initial, auto messages, auto digests) { hash_batch(initial, messages, digests); }, aligned_prefix);
+        check_batch<TestType>(count, [](const TestType& initial, auto messages, auto digests) { hash_batch(initial, messages, digests); }, unaligned_prefix);
+    }
+}
+
+#if JSRIBAR_SHA2_X86
+
+TEMPLATE_TEST_CASE("AVX2 multi-buffer implementation gives the same digests as hashing each message", "[multi-buffer]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    if (!cpu_features().avx2)
+    {
+        WARN("AVX2 is not supported by CPU");
+        return;
+    }
+
+    const std::string prefix(TestType::message_block_size_k, 'p');
+    for (size_t count : { 1, 8, 9, 100 })
+    {
+        check_batch<TestType>(count, multi_buffer::hash_avx2<TestType>);
+        check_batch<TestType>(count, multi_buffer::hash_avx2<TestType>, prefix);
+    }
+}
+
+TEMPLATE_TEST_CASE("AVX-512 multi-buffer implementation gives the same digests as hashing each message", "[multi-buffer]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    if (!cpu_features().avx512f)
+    {
+        WARN("AVX-512 is not supported by CPU");
+        return;
+    }
+
+    const std::string prefix(TestType::message_block_size_k, 'p');
+    for (size_t count : { 1, 16, 17, 100 })
+    {
+        check_batch<TestType>(count, multi_buffer::hash_avx512<TestType>);
+        check_batch<TestType>(count, multi_buffer::hash_avx512<TestType>, prefix);
+    }
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include <catch2/catch.hpp>
+
+#include <dispatch.hpp>
+#include <pbkdf2.hpp>
+
+#include <array>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+std::string to_hex(std::span<const uint8_t> bytes)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string result;
+    for (auto byte : bytes)
+    {
+        result += digits[byte >> 4];
+        result += digits[byte & 0xf];
+    }
+    return result;
+}
+
+template <typename Sha>
+std::string derive(std::string_view password, std::string_view salt, uint32_t iterations, size_t length)
+{
+    std::vector<uint8_t> key(length);
+    pbkdf2<Sha>(password, salt, iterations, key);
+    return to_hex(key);
+}
+
+// Inputs of RFC 6070 test vectors (defined there for SHA-1), with keys derived by OpenSSL.
+template <typename Sha>
+std::array<std::string_view, 5> expected_keys()
+{
+    if constexpr (std::is_same_v<Sha, sha224_t>)
+    {
+        return { "3c198cbdb9464b7857966bd05b7bc92bc1cc4e6e63155d4e490557fd85989497", "93200ffa96c5776d38fa10abdf8f5bfc0054b9718513df472d2331d2d1e66a3f", "218c453bf90635bd0a21a75d172703ff6108ef603f65bb821aedade1d6961683", "056c4ba438ded91fc14e0594e6f52b87e1f3690c0dc0fbc05784ed9a754ca780e6c017e80c8de278", "9b4011b641f40a2a500a31d4a392d15c" };
+    }
+    else if constexpr (std::is_same_v<Sha, sha256_t>)
+    {
+        return { "120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b", "ae4d0c95af6b46d32d0adff928f06dd02a303f8ef3c251dfd6e2d85a95474c43", "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a", "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9", "89b69d0516f829893c696226650a8687" };
+    }
+    else if constexpr (std::is_same_v<Sha, sha384_t>)
+    {
+        return { "c0e14f06e49e32d73f9f52ddf1d0c5c7191609233631dadd76a567db42b78676", "54f775c6d790f21930459162fc535dbf04a939185127016a04176a0730c6f1f4", "559726be38db125bc85ed7895f6e3cf574c7a01c080c3447db1e8a76764deb3c", "819143ad66df9a552559b9e131c52ae6c5c1b0eed18f4d283b8c5c9eaeb92b392c147cc2d2869d58", "a3f00ac8657e095f8e0823d232fc60b3" };
+    }
+    else if constexpr (std::is_same_v<Sha, sha512_t>)
+    {
+        return { "867f70cf1ade02cff3752599a3a53dc4af34c7a669815ae5d513554e1c8cf252", "e1d9c16aa681708a45f5c7c4e215ceb66e011a2e9f0040713f18aefdb866d53c", "d197b1b33db0143e018b12f3d1d1479e6cdebdcc97c5c0f87f6902e072f457b5", "8c0511f4c6e597c6ac6315d8f0362e225f3c501495ba23b868c005174dc4ee71115b59f9e60cd953", "9d9e9c4cd21fe4be24d5b8244c759665" };
+    }
+    else if constexpr (std::is_same_v<Sha, sha512_224_t>)
+    {
+        return { "b34ab626276a61ce19d2ecb4c7e15f8198a2989abd74ade61cd6b117812ff423", "b8878ac5e4509c165c1b508961fa3c3afcef3f37b7b081874e718d8daea67014", "ed54af699cc307e08965098bda5ff4e41ea1931f46da771c1ea9128e52f91ade", "573df96762ea7da4f71231859ca282ef482764ad9671c5275c3272fe6ae94d285a5709d1080fd6d8", "c8664f7adde2c3073c96d48a16ec507b" };
+    }
+    else
+    {
+        return { "4b6a63117d3ec0032624616082c1c1912f56fa5f0c1f94574d515e20e5ddd74a", "fcfd108c99cc888ec0af9f184885aff5f02d19a956afad9ccea4d56a482b851b", "f2fbe5f8ec3618bb145279a8c6a8dfa476c282a3ed53d8c257d51ce021d3877d", "31cf94e3d8e36aa18d40ad92654ab80f500ed7fb575a2215547db6f82dd227ed0f41215e8f9bb976", "7c7bd694768c9dea9adb8623308dc0a4" };
+    }
+}
+
+template <typename Sha>
+void check_rfc_6070_inputs()
+{
+    const auto expected = expected_keys<Sha>();
+    REQUIRE(derive<Sha>("password", "salt", 1, 32) == expected[0]);
+    REQUIRE(derive<Sha>("password", "salt", 2, 32) == expected[1]);
+    REQUIRE(derive<Sha>("password", "salt", 4096, 32) == expected[2]);
+    REQUIRE(derive<Sha>("passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096, 40) == expected[3]);
+    REQUIRE(derive<Sha>(std::string_view{ "pass\0word", 9 }, std::string_view{ "sa\0lt", 5 }, 4096, 16) == expected[4]);
+}
+
+}
+
+TEMPLATE_TEST_CASE("PBKDF2 of RFC 6070 inputs", "[PBKDF2]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    check_rfc_6070_inputs<TestType>();
+}
+
+TEST_CASE("PBKDF2-HMAC-SHA-256 of RFC 7914 test vectors", "[PBKDF2]")
+{
+    REQUIRE(derive<sha256_t>("passwd", "salt", 1, 64) == "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783");
+    REQUIRE(derive<sha256_t>("Password", "NaCl", 80000, 64) == "4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d");
+}
+
+TEMPLATE_TEST_CASE("PBKDF2 gives the same keys with all kernels", "[PBKDF2]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    for (auto kernel : { kernel_t::portable, kernel_t::sha_ni, kernel_t::avx2, kernel_t::avx512 })
+    {
+        INFO("Kernel: " << kernel_name(kernel));
+        force_kernel(kernel);
+        check_rfc_6070_inputs<TestType>();
+    }
+    force_kernel(std::nullopt);
+}
+
+TEMPLATE_TEST_CASE("Batch PBKDF2 gives the same keys as deriving each key", "[PBKDF2]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    std::vector<std::string> passwords;
+    std::vector<std::string> salts;
+    for (size_t i = 0; i < 19; ++i)
+    {
+        passwords.push_back("password" + std::to_string(i));
+        salts.push_back(std::string(i * 13, 's'));
+    }
+    const std::vector<std::string_view> password_views(passwords.begin(), passwords.end());
+    const std::vector<std::string_view> salt_views(salts.begin(), salts.end());
+
+    std::vector<std::vector<uint8_t>> keys(passwords.size(), std::vector<uint8_t>(TestType::digest_size_k + 5));
+    const std::vector<std::span<uint8_t>> key_views(keys.begin(), keys.end());
+    pbkdf2_batch<TestType>(password_views, salt_views, 100, key_views);
+
+    for (size_t i = 0; i < passwords.size(); ++i)
+    {
+        REQUIRE(to_hex(keys[i]) == derive<TestType>(passwords[i], salts[i], 100, keys[i].size()));
+    }
+}
@@ -0,0 +1,108 @@
+#include <catch2/catch.hpp>
+
+#include <sha2.hpp>
+
+#include "make_message.hpp"
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+// Splits message into fragments of different lengths, including empty ones.
+std::vector<std::string> split(const std::string& message)
+{
+    std::vector<std::string> fragments;
+    for (size_t offset = 0, length = 0; offset < message.size(); offset += length)
+    {
+        length = std::min((fragments.size() * 37) % 150, message.size() - offset);
+        fragments.push_back(message.substr(offset, length));
+    }
+    return fragments;
+}
+
+constexpr std::array<std::string_view, 3> request_k{ "GET / HTTP/1.1\r\n", "host: example.com\r\n", "\r\n" };
+
+}
+
+TEMPLATE_TEST_CASE("Contiguous ranges of bytes give the same digest as string", "[range]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    for (size_t length : { 0, 1, 55, 64, 111, 128, 1000 })
+    {
+        const auto message = make_message(length);
+        const auto expected = TestType{ message }.digest();
+
+        const std::vector<uint8_t> bytes(message.begin(), message.end());
+        REQUIRE(hash_range<TestType>(bytes) == expected);
+        REQUIRE(hash_range<TestType>(std::as_bytes(std::span{ message })) == expected);
+        REQUIRE(hash_range<TestType>(message) == expected);
+    }
+}
+
+TEMPLATE_TEST_CASE("Non-contiguous ranges give the same digest as string", "[range]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    for (size_t length : { 0, 1, 55, 64, 111, 128, 1000 })
+    {
+        const auto message = make_message(length);
+        const auto expected = TestType{ message }.digest();
+
+        const std::list<char> list(message.begin(), message.end());
+        REQUIRE(hash_range<TestType>(list) == expected);
+
+        const auto fragments = split(message);
+        REQUIRE(hash_range<TestType>(fragments | std::views::join) == expected);
+
+        std::string inverted(message);
+        for (auto& c : inverted)
+        {
+            c = char(~c);
+        }
+        REQUIRE(hash_range<TestType>(inverted | std::views::transform([](char c) { return char(~c); })) == expected);
+    }
+}
+
+TEMPLATE_TEST_CASE("Fragments give the same digest as concatenated message", "[range]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    for (size_t length : { 0, 1, 55, 64, 111, 128, 1000 })
+    {
+        const auto message = make_message(length);
+        const auto expected = TestType{ message }.digest();
+
+        const auto fragments = split(message);
+        REQUIRE(hash_range<TestType>(fragments) == expected);
+
+        std::vector<std::span<const uint8_t>> spans;
+        for (const auto& fragment : fragments)
+        {
+            spans.emplace_back(reinterpret_cast<const uint8_t*>(fragment.data()), fragment.size());
+        }
+        REQUIRE(hash_range<TestType>(std::span<const std::span<const uint8_t>>{ spans }) == expected);
+
+        // Header and body appended to a hasher with the rest of the message following.
+        const std::string_view view{ message };
+        TestType sh;
+        sh.update(std::array{ view.substr(0, length / 3), view.substr(length / 3, length / 3) });
+        sh.update(view.substr(2 * (length / 3)));
+        REQUIRE(sh.finalize() == expected);
+    }
+}
+
+TEST_CASE("Compile time evaluation of ranges", "[range]")
+{
+    constexpr auto expected = sha256("GET / HTTP/1.1\r\nhost: example.com\r\n\r\n");
+
+    STATIC_REQUIRE(hash_range<sha256_t>(request_k) == expected);
+    STATIC_REQUIRE(hash_range<sha256_t>(request_k | std::views::join) == expected);
+
+    constexpr std::array<std::byte, 3> bytes{ std::byte{ 'a' }, std::byte{ 'b' }, std::byte{ 'c' } };
+    STATIC_REQUIRE(hash_range<sha256_t>(bytes) == sha256("abc"));
+}
@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+
+#include <resource.hpp>
+
+#include "hex_to_binary.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+// Elements are generated by pack expansion rather than by a loop, which would be a single constant expression
+// with as many iterations as the resource has bytes, itself exceeding the limit of MSVC or Clang.
+template <size_t... I>
+constexpr std::array<uint8_t, sizeof...(I)> make_resource(std::index_sequence<I...>)
+{
+    return { uint8_t(I * 31 + 7)... };
+}
+
+template <size_t N>
+constexpr std::array<uint8_t, N> make_resource()
+{
+    return make_resource(std::make_index_sequence<N>{});
+}
+
+constexpr std::array<uint8_t, 0> empty_k{};
+constexpr unsigned char abc_k[]{ 'a', 'b', 'c' };
+constexpr std::array<std::byte, 3> abc_bytes_k{ std::byte{ 'a' }, std::byte{ 'b' }, std::byte{ 'c' } };
+constexpr auto chunk_k{ make_resource<resource_detail::chunk_size_k>() };
+constexpr auto chunks_k{ make_resource<resource_detail::chunk_size_k + 1001>() };
+// Exceeds default limit of constant evaluation if hashed in a single constant expression.
+constexpr auto large_k{ make_resource<16 * resource_detail::chunk_size_k + 123>() };
+
+template <typename Sha, const auto& Resource>
+void check_resource()
+{
+    INFO("Resource size: " << Resource.size());
+    const Sha sha{ reinterpret_cast<const char*>(Resource.data()), Resource.size() };
+    REQUIRE(digest_of<Sha, Resource> == sha.digest());
+}
+
+}
+
+TEST_CASE("Digests of resources evaluated at compile time", "[resource]")
+{
+    constexpr auto hex_to_binary = hex_to_binary_fun<32>;
+
+    STATIC_REQUIRE(sha256_of<empty_k> == hex_to_binary("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+    STATIC_REQUIRE(sha256_of<abc_k> == hex_to_binary("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+    STATIC_REQUIRE(sha256_of<abc_bytes_k> == sha256("abc"));
+    STATIC_REQUIRE(sha512_of<abc_k> == sha512("abc"));
+}
+
+TEMPLATE_TEST_CASE("Digests of resources match the hasher", "[resource]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    check_resource<TestType, empty_k>();
+    check_resource<TestType, chunks_k>();
+}
+
+TEST_CASE("Digests of a single chunk and of a resource larger than the constant evaluation limit", "[resource]")
+{
+    check_resource<sha256_t, chunk_k>();
+    check_resource<sha256_t, large_k>();
+}
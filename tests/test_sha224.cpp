@@ -91,3 +91,13 @@ TEST_CASE("Compile time SHA-224 evaluation", "[SHA-224]")
         STATIC_REQUIRE(sha224_t{ input, sizeof(input) - 1 }.digest() == hex_to_binary("cdcff09b353d59ec815072d18c64cd56fcbc981e1e8c93983e391657"));
     }
 }
+
+TEST_CASE("SHA-224 free function returns digest only", "[SHA-224]")
+{
+    static constexpr std::array<sha224_t::message_digest_t, 2> table{ sha224(""), sha224("abc") };
+    STATIC_REQUIRE(sizeof(table) == 2 * sha224_t::digest_size_k);
+    STATIC_REQUIRE(table[1] == hex_to_binary("23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7"));
+
+    const std::string input{ "abc" };
+    REQUIRE(sha224(input) == sha224_t{ input }.digest());
+}
@@ -93,3 +93,13 @@ TEST_CASE("Compile time SHA-256 evaluation", "[SHA-256]")
         STATIC_REQUIRE(sha256_t{ input, sizeof(input) - 1 }.digest() == hex_to_binary("cf0071a083ad3e47349d2e3fbc896d07a0d50580b335c37e397d4091bf8e713b"));
     }
 }
+
+TEST_CASE("SHA-256 free function returns digest only", "[SHA-256]")
+{
+    static constexpr std::array<sha256_t::message_digest_t, 2> table{ sha256(""), sha256("abc") };
+    STATIC_REQUIRE(sizeof(table) == 2 * sha256_t::digest_size_k);
+    STATIC_REQUIRE(table[1] == hex_to_binary("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+
+    const std::string input{ "abc" };
+    REQUIRE(sha256(input) == sha256_t{ input }.digest());
+}
@@ -97,3 +97,13 @@ TEST_CASE("Compile time SHA-384 evaluation", "[SHA-384]")
         STATIC_REQUIRE(sha384_t{ input, sizeof(input) - 1 }.digest() == hex_to_binary("83a02e35bbe121941d57840c918fa9873a0fa2aa31c15ebd282f815f5e6c2592f456b41dbfe514f3519451cf9062b6ca"));
     }
 }
+
+TEST_CASE("SHA-384 free function returns digest only", "[SHA-384]")
+{
+    static constexpr std::array<sha384_t::message_digest_t, 2> table{ sha384(""), sha384("abc") };
+    STATIC_REQUIRE(sizeof(table) == 2 * sha384_t::digest_size_k);
+    STATIC_REQUIRE(table[1] == hex_to_binary("cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7"));
+
+    const std::string input{ "abc" };
+    REQUIRE(sha384(input) == sha384_t{ input }.digest());
+}
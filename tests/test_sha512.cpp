@@ -97,3 +97,13 @@ TEST_CASE("Compile time SHA-512 evaluation", "[SHA-512]")
         STATIC_REQUIRE(sha512_t{ input, sizeof(input) - 1 }.digest() == hex_to_binary("66d32b2ea5a81c9d8bbedfb3feb83ab8ae136e80f30e7b911df9328f1033c1e6969983a4a483a0f97321311570da5bfdeaba896d82135141bfe3f2f48fb2d271"));
     }
 }
+
+TEST_CASE("SHA-512 free function returns digest only", "[SHA-512]")
+{
+    static constexpr std::array<sha512_t::message_digest_t, 2> table{ sha512(""), sha512("abc") };
+    STATIC_REQUIRE(sizeof(table) == 2 * sha512_t::digest_size_k);
+    STATIC_REQUIRE(table[1] == hex_to_binary("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"));
+
+    const std::string input{ "abc" };
+    REQUIRE(sha512(input) == sha512_t{ input }.digest());
+}
@@ -97,3 +97,13 @@ TEST_CASE("SHA-512/224 of a string with multibyte UTF8 characters", "[SHA-512/22
 //        STATIC_REQUIRE(sha512_224_t{ input, sizeof(input) - 1 }.digest() == hex_to_binary("e7ab75d2674bce8e1a5db9c60374231853a0ba1219aa8b39623ca4c2"));
 //    }
 //}
+
+TEST_CASE("SHA-512/224 free function returns digest only", "[SHA-512/224]")
+{
+    static constexpr std::array<sha512_224_t::message_digest_t, 2> table{ sha512_224(""), sha512_224("abc") };
+    STATIC_REQUIRE(sizeof(table) == 2 * sha512_224_t::digest_size_k);
+    STATIC_REQUIRE(table[1] == hex_to_binary("4634270f707b6a54daae7530460842e20e37ed265ceee9a43e8924aa"));
+
+    const std::string input{ "abc" };
+    REQUIRE(sha512_224(input) == sha512_224_t{ input }.digest());
+}
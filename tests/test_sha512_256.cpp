@@ -97,3 +97,13 @@ TEST_CASE("Compile time SHA-512/256 evaluation", "[SHA-512/256]")
         STATIC_REQUIRE(sha512_256_t{ input, sizeof(input) - 1 }.digest() == hex_to_binary("caaa78c8ab763a1f3743b67b7b0b997115277c9d442ab79fcc82847c952478a3"));
     }
 }
+
+TEST_CASE("SHA-512/256 free function returns digest only", "[SHA-512/256]")
+{
+    static constexpr std::array<sha512_256_t::message_digest_t, 2> table{ sha512_256(""), sha512_256("abc") };
+    STATIC_REQUIRE(sizeof(table) == 2 * sha512_256_t::digest_size_k);
+    STATIC_REQUIRE(table[1] == hex_to_binary("53048e2681941ef99b2e29b76b4c7dabe4c2d0c634fc6d46e0e2f13107e7af23"));
+
+    const std::string input{ "abc" };
+    REQUIRE(sha512_256(input) == sha512_256_t{ input }.digest());
+}
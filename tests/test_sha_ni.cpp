@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+
+#include <sha2.hpp>
+
+#include <string>
+
+using namespace jsribar::cryptography::sha2;
+
+#if JSRIBAR_SHA2_X86
+
+namespace
+{
+
+constexpr std::string_view message_k{ "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ" };
+
+bool sha_ni_supported()
+{
+    return cpu_features().sha && cpu_features().sse41;
+}
+
+// Message lengths around message block boundaries.
+constexpr std::array<size_t, 16> lengths_k{ 0, 1, 3, 55, 56, 62, 63, 64, 65, 119, 120, 127, 128, 129, 186, 372 };
+
+// Evaluates digests of message prefixes at compile time.
+template <typename Sha, size_t... i>
+constexpr auto prefix_digests(std::index_sequence<i...>)
+{
+    return std::array{ Sha{ message_k.substr(0, lengths_k[i]) }.digest()... };
+}
+
+template <typename Sha>
+void check_prefix_digests()
+{
+    static constexpr auto expected = prefix_digests<Sha>(std::make_index_sequence<lengths_k.size()>{});
+
+    for (size_t i = 0; i < lengths_k.size(); ++i)
+    {
+        const std::string input{ message_k.substr(0, lengths_k[i]) };
+        INFO("Message length: " << lengths_k[i]);
+        REQUIRE(Sha{ input.data(), input.size() }.digest() == expected[i]);
+    }
+}
+
+}
+
+TEST_CASE("SHA-NI implementation of SHA-256 gives the same digests as compile time evaluation", "[SHA-NI]")
+{
+    if (!sha_ni_supported())
+    {
+        WARN("SHA extensions are not supported by CPU");
+        return;
+    }
+
+    check_prefix_digests<sha256_t>();
+}
+
+TEST_CASE("SHA-NI implementation of SHA-224 gives the same digests as compile time evaluation", "[SHA-NI]")
+{
+    if (!sha_ni_supported())
+    {
+        WARN("SHA extensions are not supported by CPU");
+        return;
+    }
+
+    check_prefix_digests<sha224_t>();
+}
+
+TEST_CASE("SHA-NI compresses several consecutive message blocks at once", "[SHA-NI]")
+{
+    if (!sha_ni_supported())
+    {
+        WARN("SHA extensions are not supported by CPU");
+        return;
+    }
+
+    // Message 119 bytes long fits into two blocks with padding.
+    static constexpr auto expected = sha256_t{ message_k.substr(0, 119) }.digest();
+
+    std::array<uint8_t, 128> blocks{};
+    std::copy(message_k.begin(), message_k.begin() + 119, blocks.begin());
+    blocks[119] = 0x80;
+    to_uint8_array(uint64_t(119 * 8), blocks.data() + 120);
+
+    auto h = initial_hash_values_256_t::values;
+    sha_ni::compress<round_constants_2x_t>(h, blocks.data(), 2);
+
+    sha256_t::message_digest_t digest;
+    for (size_t i = 0; i < h.size(); ++i)
+    {
+        to_uint8_array(h[i], digest.data() + 4 * i);
+    }
+    REQUIRE(digest == expected);
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include <catch2/catch.hpp>
+
+#include <tree_hash.hpp>
+
+#include "make_message.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+// Tree hash evaluated directly from the definition: digests of all chunks combined level by level.
+sha256_t::message_digest_t reference_tree_hash(const std::string& message)
+{
+    std::vector<sha256_t::message_digest_t> chunks;
+    for (size_t offset = 0; offset < message.size() || offset == 0; offset += tree_hash_chunk_size_k)
+    {
+        chunks.push_back(sha256_t{ std::string_view{ message }.substr(offset, tree_hash_chunk_size_k) }.digest());
+    }
+    return tree_hash_root(chunks);
+}
+
+}
+
+TEST_CASE("Tree hash of message of a single chunk equals its digest", "[tree hash]")
+{
+    for (const size_t size : { size_t(0), size_t(1), size_t(1000), tree_hash_chunk_size_k })
+    {
+        const auto message = make_message(size);
+        const auto result = tree_hash(message, 2);
+        const auto digest = sha256_t{ message }.digest();
+        CHECK(result.tree == digest);
+        CHECK(result.linear == digest);
+    }
+}
+
+TEST_CASE("Tree root combines pairs of digests and promotes odd digest", "[tree hash]")
+{
+    const auto a = sha256_t{ "a" }.digest();
+    const auto b = sha256_t{ "b" }.digest();
+    const auto c = sha256_t{ "c" }.digest();
+    const auto concatenate = [](const auto& left, const auto& right)
+        {
+            return std::string{ left.begin(), left.end() } + std::string{ right.begin(), right.end() };
+        };
+    const auto ab = sha256_t{ concatenate(a, b) }.digest();
+
+    CHECK(tree_hash_root(std::vector{ a }) == a);
+    CHECK(tree_hash_root(std::vector{ a, b }) == ab);
+    CHECK(tree_hash_root(std::vector{ a, b, c }) == sha256_t{ concatenate(ab, c) }.digest());
+}
+
+TEST_CASE("Tree hash of message of many chunks equals the reference", "[tree hash]")
+{
+    for (const size_t chunks : { 2, 3, 5, 8, 9 })
+    {
+        for (const size_t tail : { 0, 1 })
+        {
+            const auto message = make_message(chunks * tree_hash_chunk_size_k + tail);
+            const auto expected = reference_tree_hash(message);
+            const auto linear = sha256_t{ message }.digest();
+            for (const size_t threads : { 1, 2, 3, 5 })
+            {
+                const auto result = tree_hash(message, threads);
+                CHECK(result.tree == expected);
+                CHECK(result.linear == linear);
+            }
+            CHECK(tree_hash(message, 2, false).linear == sha256_t::message_digest_t{});
+        }
+    }
+}
+
+TEST_CASE("Tree hash of message appended in parts equals the reference", "[tree hash]")
+{
+    const auto message = make_message(7 * tree_hash_chunk_size_k + 12345);
+    const auto expected = reference_tree_hash(message);
+    for (const size_t part : { size_t(65536), size_t(1000003), size_t(3) * tree_hash_chunk_size_k + 7 })
+    {
+        tree_hasher_t hasher{ 3 };
+        for (size_t offset = 0; offset < message.size(); offset += part)
+        {
+            hasher.update(std::string_view{ message }.substr(offset, part));
+        }
+        const auto result = hasher.finalize();
+        CHECK(result.tree == expected);
+        CHECK(result.linear == sha256_t{ message }.digest());
+        CHECK(hasher.finalize().tree == expected);
+    }
+}
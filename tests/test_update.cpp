@@ -0,0 +1,202 @@
+#include <catch2/catch.hpp>
+
+#include <dispatch.hpp>
+#include <sha2.hpp>
+
+#include "hex_to_binary.hpp"
+#include "make_message.hpp"
+
+#include <array>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+constexpr sha256_t streamed_sha256(std::string_view first, std::string_view second)
+{
+    sha256_t sh;
+    sh.update(first);
+    sh.update(second);
+    sh.finalize();
+    return sh;
+}
+
+constexpr sha512_t streamed_sha512(std::string_view first, std::string_view second)
+{
+    sha512_t sh;
+    sh.update(first);
+    sh.update(second);
+    sh.finalize();
+    return sh;
+}
+
+// Long message is appended in two chunks, so that blocks both buffered and read directly from the input are compressed.
+template <typename Sha>
+constexpr Sha streamed_long_message()
+{
+    std::array<char, 65536> message{};
+    for (size_t i = 0; i < message.size(); ++i)
+    {
+        message[i] = message_byte(i);
+    }
+    Sha sh;
+    sh.update(message.data(), 1000);
+    sh.update(message.data() + 1000, message.size() - 1000);
+    sh.finalize();
+    return sh;
+}
+
+}
+
+TEMPLATE_TEST_CASE("Message appended in chunks gives the same digest as entire message", "[update]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    for (size_t length : { 0, 1, 55, 56, 63, 64, 65, 111, 112, 127, 128, 129, 300, 1000 })
+    {
+        const auto message = make_message(length);
+        const auto expected = TestType{ message.data(), message.size() }.digest();
+
+        for (size_t chunk : { 1, 3, 17, 64, 127, 128, 500 })
+        {
+            TestType sh;
+            for (size_t offset = 0; offset < length; offset += chunk)
+            {
+                sh.update(message.data() + offset, std::min(chunk, length - offset));
+            }
+            REQUIRE(sh.finalize() == expected);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Blocks compressed directly from unaligned input give the same digest with all kernels", "[update]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    const auto message = make_message(4000);
+    const auto expected = TestType{ message.data(), message.size() }.digest();
+
+    for (auto kernel : { kernel_t::portable, kernel_t::sha_ni, kernel_t::avx2, kernel_t::avx512 })
+    {
+        INFO("Kernel: " << kernel_name(kernel));
+        force_kernel(kernel);
+        for (size_t offset : { 1, 3, 7 })
+        {
+            const std::string buffer = std::string(offset, 'x') + message;
+            TestType sh;
+            sh.update(buffer.data() + offset, 5);
+            sh.update(buffer.data() + offset + 5, message.size() - 5);
+            REQUIRE(sh.finalize() == expected);
+        }
+    }
+    force_kernel(std::nullopt);
+}
+
+TEMPLATE_TEST_CASE("Short message hashed in a single block gives the same digest as message appended", "[update]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    for (size_t length = 0; length <= TestType::message_block_size_k; ++length)
+    {
+        INFO("Message length: " << length);
+        const auto message = make_message(length);
+        const TestType hashed{ message.data(), message.size() };
+
+        TestType appended;
+        appended.update(message);
+        REQUIRE(hashed.digest() == appended.finalize());
+        REQUIRE(hashed.message_length() == length);
+    }
+}
+
+TEMPLATE_TEST_CASE("Default constructed hasher gives digest of empty string", "[update]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    TestType sh;
+    REQUIRE(sh.finalize() == TestType{ "" }.digest());
+}
+
+TEMPLATE_TEST_CASE("Finalize can be called repeatedly", "[update]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    TestType sh;
+    sh.update("abc");
+    const auto first = sh.finalize();
+    REQUIRE(sh.finalize() == first);
+    REQUIRE(sh.digest() == first);
+}
+
+TEMPLATE_TEST_CASE("Digest of hasher not finalized yet does not affect its state", "[update]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    TestType sh;
+    sh.update("abc");
+    REQUIRE(sh.digest() == TestType{ "abc" }.digest());
+
+    sh.update("def");
+    REQUIRE(sh.digest() == TestType{ "abcdef" }.digest());
+    REQUIRE(sh.finalize() == TestType{ "abcdef" }.digest());
+}
+
+TEST_CASE("Compile time evaluation of message appended in chunks", "[update]")
+{
+    SECTION("SHA-256")
+    {
+        constexpr auto hex_to_binary = hex_to_binary_fun<32>;
+        STATIC_REQUIRE(streamed_sha256("abcdefghijklmnopqrstuvwxyz0123456789", "ABCDEFGHIJKLMNOPQRSTUVWXYZ!@#").digest() == hex_to_binary("b780d798616b8ef8fe461f3440a80e3f7990166b097df34a4701bb3246fd3827"));
+    }
+
+    SECTION("SHA-512")
+    {
+        constexpr auto hex_to_binary = hex_to_binary_fun<64>;
+        STATIC_REQUIRE(streamed_sha512("abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz", "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcde").digest() == hex_to_binary("91adba6efb00cce51e959adaa535adc04fc0e6232690bc415d2d93277c982ee2f20bcba34e5e6158f9727a8f2f119b7d3ed5247405da68384386bbec173c32f6"));
+    }
+}
+
+// 64 KiB message fits into the default limit of GCC (-fconstexpr-ops-limit=33554432), but exceeds the defaults of
+// Clang (-fconstexpr-steps=1048576) and MSVC (/constexpr:steps100000), so it is evaluated at compile time only with GCC.
+#if defined(__GNUC__) && !defined(__clang__)
+#define LONG_MESSAGE_REQUIRE STATIC_REQUIRE
+#else
+#define LONG_MESSAGE_REQUIRE REQUIRE
+#endif
+
+TEST_CASE("Compile time evaluation of 64 KiB message within default constant evaluation limit of GCC", "[update]")
+{
+    SECTION("SHA-256")
+    {
+        constexpr auto hex_to_binary = hex_to_binary_fun<32>;
+        LONG_MESSAGE_REQUIRE(streamed_long_message<sha256_t>().digest() == hex_to_binary("72b4b518d11299b9476f03c4d44f95cea481c5b2b3ccddd7bd0064e004ddde88"));
+        REQUIRE(sha256_t{ make_message(65536) }.digest() == hex_to_binary("72b4b518d11299b9476f03c4d44f95cea481c5b2b3ccddd7bd0064e004ddde88"));
+    }
+
+    SECTION("SHA-512")
+    {
+        constexpr auto hex_to_binary = hex_to_binary_fun<64>;
+        LONG_MESSAGE_REQUIRE(streamed_long_message<sha512_t>().digest() == hex_to_binary("6450dbb8f3394218dcc4454ec3cc7ded7d0b6de7a2fb5828ea6ad31a7acbd2df2faef001427a7e7a872c0518fcc8feda0f42a9d599157f8beda1f00f03b36807"));
+        REQUIRE(sha512_t{ make_message(65536) }.digest() == hex_to_binary("6450dbb8f3394218dcc4454ec3cc7ded7d0b6de7a2fb5828ea6ad31a7acbd2df2faef001427a7e7a872c0518fcc8feda0f42a9d599157f8beda1f00f03b36807"));
+    }
+}
+
+TEMPLATE_TEST_CASE("Hasher with prefix appended at compile time gives the same digest as entire message", "[update]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    // Prefix is longer than a message block of all algorithms and ends inside a block.
+    static constexpr char prefix[] = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    static constexpr auto prefixed = midstate<TestType>(prefix);
+
+    for (size_t length : { 0, 1, 50, 200 })
+    {
+        const auto suffix = make_message(length);
+        auto sh{ prefixed };
+        sh.update(suffix);
+        REQUIRE(sh.finalize() == TestType{ std::string{ prefix } + suffix }.digest());
+    }
+}
+
+TEMPLATE_TEST_CASE("Copy of a running hasher continues independently", "[update]", sha224_t, sha256_t, sha384_t, sha512_t, sha512_224_t, sha512_256_t)
+{
+    STATIC_REQUIRE(std::is_trivially_copyable_v<TestType>);
+
+    TestType transcript;
+    transcript.update("client hello");
+    auto fork{ transcript };
+    transcript.update("server hello");
+
+    REQUIRE(fork.finalize() == TestType{ "client hello" }.digest());
+    REQUIRE(transcript.finalize() == TestType{ "client helloserver hello" }.digest());
+}
@@ -114,6 +114,58 @@ TEST_CASE("to_uint8_array converts unsigned integer to a sequence of big-endian
     }
 }
 
+TEST_CASE("byte_swap reverses order of bytes", "[byte_swap]")
+{
+    SECTION("Compile time")
+    {
+        STATIC_REQUIRE(byte_swap(uint8_t(0x01)) == uint8_t(0x01));
+        STATIC_REQUIRE(byte_swap(uint16_t(0x0102)) == uint16_t(0x0201));
+        STATIC_REQUIRE(byte_swap(uint32_t(0x01020304)) == uint32_t(0x04030201));
+        STATIC_REQUIRE(byte_swap(uint64_t(0x0102030405060708)) == uint64_t(0x0807060504030201));
+    }
+
+    SECTION("Runtime")
+    {
+        REQUIRE(byte_swap(uint16_t(0x0102)) == uint16_t(0x0201));
+        REQUIRE(byte_swap(uint32_t(0x01020304)) == uint32_t(0x04030201));
+        REQUIRE(byte_swap(uint64_t(0x0102030405060708)) == uint64_t(0x0807060504030201));
+    }
+}
+
+TEST_CASE("load_big_endian reads big-endian word", "[load_big_endian]")
+{
+    static constexpr std::array<uint8_t, 9> data{ 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09 };
+
+    SECTION("Compile time")
+    {
+        STATIC_REQUIRE(load_big_endian<uint32_t>(data.data()) == uint32_t(0x01020304));
+        STATIC_REQUIRE(load_big_endian<uint64_t>(data.data()) == uint64_t(0x0102030405060708));
+    }
+
+    SECTION("Runtime from unaligned address")
+    {
+        REQUIRE(load_big_endian<uint32_t>(data.data() + 1) == uint32_t(0x02030405));
+        REQUIRE(load_big_endian<uint64_t>(data.data() + 1) == uint64_t(0x0203040506070809));
+    }
+}
+
+TEST_CASE("store_big_endian writes big-endian word", "[store_big_endian]")
+{
+    std::array<uint8_t, 9> buffer{ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+    SECTION("uint32_t to unaligned address")
+    {
+        store_big_endian(uint32_t(0x01020304), buffer.data() + 1);
+        REQUIRE(memcmp(buffer.data(), "\xFF\x01\x02\x03\x04\xFF\xFF\xFF\xFF", 9) == 0);
+    }
+
+    SECTION("uint64_t to unaligned address")
+    {
+        store_big_endian(uint64_t(0x0102030405060708), buffer.data() + 1);
+        REQUIRE(memcmp(buffer.data(), "\xFF\x01\x02\x03\x04\x05\x06\x07\x08", 9) == 0);
+    }
+}
+
 TEST_CASE("right_rotate rotates bits by offset provided", "[right_rotate]")
 {
     SECTION("uint8_t")
@@ -0,0 +1,837 @@
+// Computes and checks SHA-2 message digests of files, with output compatible with sha224sum, sha256sum, sha384sum
+// and sha512sum of GNU coreutils. Algorithm is selected by the name of the executable (e.g. a link named
+// sha512sum) or by --algorithm option. Files are hashed in parallel by a work-stealing thread pool: each thread
+// takes files from the front of its own range and, when done, steals files from the back of the other ranges.
+// Large files are memory-mapped and read sequentially, small files are read at once and hashed together in
+// multiple SIMD lanes (see hash_batch()). Digests are printed in the order of the files.
+//
+// Usage: sha2sum [OPTION]... [FILE]...
+//   -a, --algorithm <224|256|384|512>  algorithm (default by executable name, otherwise 256)
+//   -b, --binary                       mark files as read in binary mode ('*' before the file name)
+//   -c, --check                        read digests from the FILEs and check them
+//   -j, --threads <count>              number of threads (default: number of hardware threads)
+//   -t, --text                         mark files as read in text mode (default)
+//       --tag                          print BSD-style digests
+//       --ignore-missing               in check mode, do not report missing files
+//       --quiet                        in check mode, do not print OK for verified files
+//       --status                       in check mode, do not print anything, exit status reports the result
+//       --strict                       in check mode, exit with failure for improperly formatted lines
+//   -w, --warn                         in check mode, warn about improperly formatted lines
+
+#include <multi_buffer.hpp>
+#include <sha2.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define JSRIBAR_SHA2_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define JSRIBAR_SHA2_POSIX 0
+#endif
+
+using namespace jsribar::cryptography::sha2;
+
+namespace
+{
+
+// Files up to this size are read at once and hashed in batches, larger ones are memory-mapped.
+constexpr size_t small_file_size_k{ size_t(256) << 10 };
+// Chunk of data read from pipes, devices and files that cannot be mapped.
+constexpr size_t read_chunk_size_k{ size_t(1) << 20 };
+
+std::string program_name{ "sha2sum" };
+
+struct options_t
+{
+    unsigned bits{ 256 };
+    bool check{ false };
+    bool binary{ false };
+    bool tag{ false };
+    bool ignore_missing{ false };
+    bool quiet{ false };
+    bool status{ false };
+    bool strict{ false };
+    bool warn{ false };
+    size_t threads{ 0 };
+    std::vector<std::string> files;
+};
+
+// Digest or error of a single file. Done flag is set by the worker thread once the result is available.
+struct result_t
+{
+    std::string digest;
+    std::string error;
+    bool missing{ false };
+    std::atomic<bool> done{ false };
+};
+
+std::string to_hex(std::span<const uint8_t> digest)
+{
+    static constexpr char digits[]{ "0123456789abcdef" };
+    std::string hex;
+    hex.reserve(digest.size() * 2);
+    for (auto byte : digest)
+    {
+        hex.push_back(digits[byte >> 4]);
+        hex.push_back(digits[byte & 0xf]);
+    }
+    return hex;
+}
+
+// Reads the file to the end in chunks, passing each chunk to the consumer. Returns false on read error.
+template <typename Consumer>
+bool read_stream(std::FILE* file, Consumer consume)
+{
+    std::vector<char> buffer(read_chunk_size_k);
+    while (const auto length = std::fread(buffer.data(), 1, buffer.size(), file))
+    {
+        consume(buffer.data(), length);
+    }
+    return !std::ferror(file);
+}
+
+// Hashes files of one thread. Small files are collected until there are enough of them to fill the SIMD lanes.
+template <typename Sha>
+class file_hasher_t
+{
+public:
+    explicit file_hasher_t(std::vector<std::string>& paths, std::vector<result_t>& results)
+        : paths_m{ paths }
+        , results_m{ results }
+        , lanes_m{ batch_lanes<Sha>(batch_kernel<Sha>()) }
+    {
+    }
+
+    void hash(size_t index)
+    {
+        auto& result = results_m[index];
+        const auto& path = paths_m[index];
+        if (path == "-")
+        {
+            Sha sh;
+            if (!read_stream(stdin, [&](const char* data, size_t length) { sh.update(data, length); }))
+            {
+                result.error = std::strerror(errno);
+            }
+            complete(index, sh.finalize());
+            return;
+        }
+
+#if JSRIBAR_SHA2_POSIX
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat status;
+        if (fd < 0 || ::fstat(fd, &status) != 0)
+        {
+            fail(index, errno);
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            return;
+        }
+        if (S_ISDIR(status.st_mode))
+        {
+            ::close(fd);
+            fail(index, EISDIR);
+            return;
+        }
+
+        const auto size = size_t(status.st_size);
+        if (S_ISREG(status.st_mode) && size <= small_file_size_k)
+        {
+            read_small(index, fd, size);
+        }
+        else if (!S_ISREG(status.st_mode) || !hash_mapped(index, fd, size))
+        {
+            hash_stream(index, fd);
+        }
+        ::close(fd);
+#else
+        auto file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+        {
+            fail(index, errno);
+            return;
+        }
+        Sha sh;
+        if (!read_stream(file, [&](const char* data, size_t length) { sh.update(data, length); }))
+        {
+            fail(index, errno);
+        }
+        else
+        {
+            complete(index, sh.finalize());
+        }
+        std::fclose(file);
+#endif
+    }
+
+    // Hashes small files collected so far.
+    void flush()
+    {
+        if (batch_size_m == 0)
+        {
+            return;
+        }
+        std::vector<std::string_view> messages;
+        for (size_t i = 0; i < batch_size_m; ++i)
+        {
+            messages.emplace_back(batch_m[i].data(), batch_m[i].size());
+        }
+        std::vector<typename Sha::message_digest_t> digests(batch_size_m);
+        hash_batch<Sha>(std::span<const std::string_view>{ messages }, std::span{ digests });
+        for (size_t i = 0; i < batch_size_m; ++i)
+        {
+            complete(batch_indices_m[i], digests[i]);
+        }
+        batch_size_m = 0;
+    }
+
+private:
+    std::vector<std::string>& paths_m;
+    std::vector<result_t>& results_m;
+    const size_t lanes_m;
+
+    // Contents of small files in the batch; buffers are reused.
+    std::vector<std::vector<char>> batch_m;
+    std::vector<size_t> batch_indices_m;
+    size_t batch_size_m{ 0 };
+
+    void complete(size_t index, const typename Sha::message_digest_t& digest)
+    {
+        auto& result = results_m[index];
+        if (result.error.empty())
+        {
+            result.digest = to_hex(digest);
+        }
+        result.done.store(true, std::memory_order_release);
+        result.done.notify_one();
+    }
+
+    void fail(size_t index, int error)
+    {
+        auto& result = results_m[index];
+        result.error = std::strerror(error);
+        result.missing = error == ENOENT;
+        result.done.store(true, std::memory_order_release);
+        result.done.notify_one();
+    }
+
+#if JSRIBAR_SHA2_POSIX
+
+    void read_small(size_t index, int fd, size_t size)
+    {
+        if (batch_m.size() == batch_size_m)
+        {
+            batch_m.emplace_back();
+            batch_indices_m.emplace_back();
+        }
+        auto& buffer = batch_m[batch_size_m];
+        buffer.resize(size);
+        for (size_t offset = 0; offset < size;)
+        {
+            const auto length = ::pread(fd, buffer.data() + offset, size - offset, off_t(offset));
+            if (length < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (length <= 0)
+            {
+                // File has been truncated or cannot be read; read it as a stream to report the actual outcome.
+                hash_stream(index, fd);
+                return;
+            }
+            offset += size_t(length);
+        }
+        batch_indices_m[batch_size_m] = index;
+        if (++batch_size_m == lanes_m)
+        {
+            flush();
+        }
+    }
+
+    // Returns false if the file cannot be mapped.
+    bool hash_mapped(size_t index, int fd, size_t size)
+    {
+        const auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+        ::madvise(data, size, MADV_SEQUENTIAL);
+
+        Sha sh;
+        sh.update(static_cast<const char*>(data), size);
+        ::munmap(data, size);
+        complete(index, sh.finalize());
+        return true;
+    }
+
+    void hash_stream(size_t index, int fd)
+    {
+        Sha sh;
+        std::vector<char> buffer(read_chunk_size_k);
+        off_t offset = 0;
+        while (true)
+        {
+            const auto length = ::pread(fd, buffer.data(), buffer.size(), offset);
+            if (length < 0 && errno == ESPIPE)
+            {
+                // Pipes and character devices are read sequentially.
+                const auto read = ::read(fd, buffer.data(), buffer.size());
+                if (read <= 0)
+                {
+                    if (read < 0)
+                    {
+                        fail(index, errno);
+                        return;
+                    }
+                    break;
+                }
+                sh.update(buffer.data(), size_t(read));
+                continue;
+            }
+            if (length < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (length < 0)
+            {
+                fail(index, errno);
+                return;
+            }
+            if (length == 0)
+            {
+                break;
+            }
+            sh.update(buffer.data(), size_t(length));
+            offset += length;
+        }
+        complete(index, sh.finalize());
+    }
+
+#endif
+};
+
+// Range of file indices of a thread. The owner takes files from the front, other threads steal from the back.
+struct work_queue_t
+{
+    std::mutex mutex;
+    size_t front{ 0 };
+    size_t back{ 0 };
+
+    std::optional<size_t> take()
+    {
+        std::lock_guard lock{ mutex };
+        return front < back ? std::optional{ front++ } : std::nullopt;
+    }
+
+    std::optional<size_t> steal()
+    {
+        std::lock_guard lock{ mutex };
+        return front < back ? std::optional{ --back } : std::nullopt;
+    }
+};
+
+// Hashes all files in the given number of threads and calls the printer for each result in the order of files,
+// as soon as the result is available.
+template <typename Sha, typename Printer>
+void hash_files(std::vector<std::string>& paths, size_t threads, Printer print)
+{
+    std::vector<result_t> results(paths.size());
+    threads = std::clamp<size_t>(threads, 1, std::max<size_t>(paths.size(), 1));
+
+    std::vector<work_queue_t> queues(threads);
+    for (size_t i = 0; i < threads; ++i)
+    {
+        queues[i].front = paths.size() * i / threads;
+        queues[i].back = paths.size() * (i + 1) / threads;
+    }
+
+    const auto work = [&](size_t thread)
+        {
+            file_hasher_t<Sha> hasher{ paths, results };
+            while (true)
+            {
+                auto index = queues[thread].take();
+                for (size_t i = 1; !index && i < threads; ++i)
+                {
+                    index = queues[(thread + i) % threads].steal();
+                }
+                if (!index)
+                {
+                    break;
+                }
+                hasher.hash(*index);
+            }
+            hasher.flush();
+        };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(work, i);
+    }
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        results[i].done.wait(false, std::memory_order_acquire);
+        print(i, results[i]);
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+// Prints an error message; standard output is flushed first, so that messages keep their order when both are
+// redirected to the same file.
+template <typename... Args>
+void error(const char* format, Args... args)
+{
+    std::fflush(stdout);
+    std::fprintf(stderr, "%s: ", program_name.c_str());
+    std::fprintf(stderr, format, args...);
+    std::fputc('\n', stderr);
+}
+
+std::string algorithm_name(unsigned bits)
+{
+    return "SHA" + std::to_string(bits);
+}
+
+// File names with backslashes or line breaks are escaped, and the line is then prefixed by a backslash. Results
+// of the check mode are escaped only if the name contains line breaks.
+bool escape(std::string_view name, std::string& escaped, bool line_breaks_only = false)
+{
+    escaped.clear();
+    bool needs_escape = false;
+    for (auto c : name)
+    {
+        switch (c)
+        {
+        case '\\':
+            escaped += "\\\\";
+            needs_escape |= !line_breaks_only;
+            break;
+        case '\n':
+            escaped += "\\n";
+            needs_escape = true;
+            break;
+        case '\r':
+            escaped += "\\r";
+            needs_escape = true;
+            break;
+        default:
+            escaped.push_back(c);
+        }
+    }
+    return needs_escape;
+}
+
+std::optional<std::string> unescape(std::string_view name)
+{
+    std::string result;
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        if (name[i] != '\\')
+        {
+            result.push_back(name[i]);
+            continue;
+        }
+        if (++i == name.size())
+        {
+            return std::nullopt;
+        }
+        switch (name[i])
+        {
+        case '\\':
+            result.push_back('\\');
+            break;
+        case 'n':
+            result.push_back('\n');
+            break;
+        case 'r':
+            result.push_back('\r');
+            break;
+        default:
+            return std::nullopt;
+        }
+    }
+    return result;
+}
+
+template <typename Sha>
+int compute(const options_t& options)
+{
+    auto paths = options.files;
+    int exit_code = 0;
+    std::string escaped;
+    hash_files<Sha>(paths, options.threads, [&](size_t i, const result_t& result)
+        {
+            if (!result.error.empty())
+            {
+                error("%s: %s", paths[i].c_str(), result.error.c_str());
+                exit_code = 1;
+                return;
+            }
+            const bool escaped_name = escape(paths[i], escaped);
+            if (options.tag)
+            {
+                std::printf("%s%s (%s) = %s\n", escaped_name ? "\\" : "", algorithm_name(options.bits).c_str(), escaped.c_str(), result.digest.c_str());
+            }
+            else
+            {
+                std::printf("%s%s %c%s\n", escaped_name ? "\\" : "", result.digest.c_str(), options.binary ? '*' : ' ', escaped.c_str());
+            }
+        });
+    return exit_code;
+}
+
+// Parses a line of a checksum file in GNU ("digest  name" or "digest *name") or BSD ("SHA256 (name) = digest")
+// format. Returns false if the line is improperly formatted.
+bool parse_check_line(std::string_view line, unsigned bits, std::string& digest, std::string& name)
+{
+    const size_t digest_length = bits / 4;
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+    const bool escaped = !line.empty() && line.front() == '\\';
+    if (escaped)
+    {
+        line.remove_prefix(1);
+    }
+
+    std::string_view raw_name;
+    const auto tag = algorithm_name(bits) + " (";
+    if (line.starts_with(tag))
+    {
+        const auto separator = line.rfind(") = ");
+        if (separator == std::string_view::npos || separator < tag.size())
+        {
+            return false;
+        }
+        raw_name = line.substr(tag.size(), separator - tag.size());
+        digest = line.substr(separator + 4);
+    }
+    else
+    {
+        if (line.size() < digest_length + 2 || line[digest_length] != ' ' || (line[digest_length + 1] != ' ' && line[digest_length + 1] != '*'))
+        {
+            return false;
+        }
+        digest = line.substr(0, digest_length);
+        raw_name = line.substr(digest_length + 2);
+    }
+
+    if (digest.size() != digest_length || raw_name.empty())
+    {
+        return false;
+    }
+    for (auto& c : digest)
+    {
+        if (!std::isxdigit(static_cast<unsigned char>(c)))
+        {
+            return false;
+        }
+        c = char(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (escaped)
+    {
+        const auto unescaped = unescape(raw_name);
+        if (!unescaped)
+        {
+            return false;
+        }
+        name = *unescaped;
+    }
+    else
+    {
+        name = raw_name;
+    }
+    return true;
+}
+
+void warn_count(size_t count, const char* singular, const char* plural)
+{
+    if (count > 0)
+    {
+        error("WARNING: %zu %s", count, count == 1 ? singular : plural);
+    }
+}
+
+template <typename Sha>
+int check(const options_t& options)
+{
+    const auto files = options.files.empty() ? std::vector<std::string>{ "-" } : options.files;
+    int exit_code = 0;
+    for (const auto& file : files)
+    {
+        std::ifstream stream;
+        if (file != "-")
+        {
+            stream.open(file, std::ios::binary);
+            if (!stream)
+            {
+                error("%s: %s", file.c_str(), std::strerror(errno));
+                exit_code = 1;
+                continue;
+            }
+        }
+        auto& input = file == "-" ? std::cin : stream;
+
+        std::vector<std::string> paths;
+        std::vector<std::string> expected;
+        std::vector<size_t> line_numbers;
+        std::vector<size_t> improperly_formatted_lines;
+        std::string line;
+        std::string digest;
+        std::string name;
+        for (size_t line_number = 1; std::getline(input, line); ++line_number)
+        {
+            if (!parse_check_line(line, options.bits, digest, name))
+            {
+                improperly_formatted_lines.push_back(line_number);
+                continue;
+            }
+            paths.push_back(name);
+            expected.push_back(digest);
+            line_numbers.push_back(line_number);
+        }
+
+        // Warnings about improperly formatted lines are printed in the order of lines, between results.
+        size_t reported = 0;
+        const auto report_improperly_formatted = [&](size_t before_line)
+            {
+                for (; reported < improperly_formatted_lines.size() && improperly_formatted_lines[reported] < before_line; ++reported)
+                {
+                    if (options.warn)
+                    {
+                        error("%s: %zu: improperly formatted %s checksum line", file.c_str(), improperly_formatted_lines[reported],
+                            algorithm_name(options.bits).c_str());
+                    }
+                }
+            };
+        const auto improperly_formatted = improperly_formatted_lines.size();
+
+        if (paths.empty())
+        {
+            report_improperly_formatted(SIZE_MAX);
+            error("%s: no properly formatted checksum lines found", file.c_str());
+            exit_code = 1;
+            continue;
+        }
+
+        size_t failed = 0;
+        size_t unreadable = 0;
+        size_t verified = 0;
+        std::string escaped;
+        hash_files<Sha>(paths, options.threads, [&](size_t i, const result_t& result)
+            {
+                report_improperly_formatted(line_numbers[i]);
+                const bool escaped_name = escape(paths[i], escaped, true);
+                if (!escaped_name)
+                {
+                    escaped = paths[i];
+                }
+                const auto prefix = escaped_name ? "\\" : "";
+                if (!result.error.empty())
+                {
+                    if (result.missing && options.ignore_missing)
+                    {
+                        return;
+                    }
+                    ++unreadable;
+                    error("%s: %s", paths[i].c_str(), result.error.c_str());
+                    if (!options.status)
+                    {
+                        std::printf("%s%s: FAILED open or read\n", prefix, escaped.c_str());
+                    }
+                    return;
+                }
+                ++verified;
+                if (result.digest != expected[i])
+                {
+                    ++failed;
+                    if (!options.status)
+                    {
+                        std::printf("%s%s: FAILED\n", prefix, escaped.c_str());
+                    }
+                }
+                else if (!options.quiet && !options.status)
+                {
+                    std::printf("%s%s: OK\n", prefix, escaped.c_str());
+                }
+            });
+        report_improperly_formatted(SIZE_MAX);
+
+        if (!options.status)
+        {
+            warn_count(improperly_formatted, "line is improperly formatted", "lines are improperly formatted");
+            warn_count(unreadable, "listed file could not be read", "listed files could not be read");
+            warn_count(failed, "computed checksum did NOT match", "computed checksums did NOT match");
+        }
+        if (options.ignore_missing && verified == 0)
+        {
+            if (!options.status)
+            {
+                error("%s: no file was verified", file.c_str());
+            }
+            exit_code = 1;
+        }
+        if (failed > 0 || unreadable > 0 || (options.strict && improperly_formatted > 0))
+        {
+            exit_code = 1;
+        }
+    }
+    return exit_code;
+}
+
+template <typename Sha>
+int run(const options_t& options)
+{
+    return options.check ? check<Sha>(options) : compute<Sha>(options);
+}
+
+bool parse_options(int argc, char* argv[], options_t& options)
+{
+    // Default algorithm is given by the name of the executable, e.g. sha512sum.
+    for (unsigned bits : { 224, 256, 384, 512 })
+    {
+        if (program_name.find("sha" + std::to_string(bits)) != std::string::npos)
+        {
+            options.bits = bits;
+        }
+    }
+
+    bool only_files = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view option{ argv[i] };
+        if (only_files || option == "-" || !option.starts_with("-"))
+        {
+            options.files.emplace_back(option);
+        }
+        else if (option == "--")
+        {
+            only_files = true;
+        }
+        else if (option == "-a" || option == "--algorithm" || option == "-j" || option == "--threads")
+        {
+            if (++i == argc)
+            {
+                return false;
+            }
+            const auto value = std::strtoul(argv[i], nullptr, 10);
+            if (option == "-a" || option == "--algorithm")
+            {
+                if (value != 224 && value != 256 && value != 384 && value != 512)
+                {
+                    return false;
+                }
+                options.bits = unsigned(value);
+            }
+            else
+            {
+                options.threads = value;
+            }
+        }
+        else if (option == "-b" || option == "--binary")
+        {
+            options.binary = true;
+        }
+        else if (option == "-t" || option == "--text")
+        {
+            options.binary = false;
+        }
+        else if (option == "-c" || option == "--check")
+        {
+            options.check = true;
+        }
+        else if (option == "--tag")
+        {
+            options.tag = true;
+        }
+        else if (option == "--ignore-missing")
+        {
+            options.ignore_missing = true;
+        }
+        else if (option == "--quiet")
+        {
+            options.quiet = true;
+        }
+        else if (option == "--status")
+        {
+            options.status = true;
+        }
+        else if (option == "--strict")
+        {
+            options.strict = true;
+        }
+        else if (option == "-w" || option == "--warn")
+        {
+            options.warn = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if (options.files.empty())
+    {
+        options.files.emplace_back("-");
+    }
+    if (options.threads == 0)
+    {
+        options.threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string_view executable{ argv[0] };
+    program_name = executable.substr(executable.find_last_of("/\\") + 1);
+
+    options_t options;
+    if (!parse_options(argc, argv, options))
+    {
+        std::fprintf(stderr, "Usage: %s [-a 224|256|384|512] [-b|-t] [-c] [-j <threads>] [--tag] [--ignore-missing] [--quiet] [--status] [--strict] [-w] [FILE]...\n",
+            program_name.c_str());
+        return 1;
+    }
+
+    switch (options.bits)
+    {
+    case 224:
+        return run<sha224_t>(options);
+    case 384:
+        return run<sha384_t>(options);
+    case 512:
+        return run<sha512_t>(options);
+    default:
+        return run<sha256_t>(options);
+    }
+}
@@ -0,0 +1,18 @@
+# Creates the files hashed by the sha2sum tests in DIRECTORY. Names with a backslash and a line break, which need
+# escaping, are not portable to all file systems, so the files are created at test time rather than kept in the
+# repository.
+#
+# Usage: cmake -DDIRECTORY=<directory> -P create_files.cmake
+
+cmake_minimum_required(VERSION 3.28)
+
+if (NOT DEFINED DIRECTORY)
+    message(FATAL_ERROR "DIRECTORY must be defined")
+endif()
+
+file(REMOVE_RECURSE ${DIRECTORY})
+file(MAKE_DIRECTORY ${DIRECTORY})
+file(WRITE ${DIRECTORY}/abc.txt "abc")
+file(WRITE ${DIRECTORY}/empty.txt "")
+file(WRITE "${DIRECTORY}/back\\slash.txt" "abc")
+file(WRITE "${DIRECTORY}/new\nline.txt" "abc")
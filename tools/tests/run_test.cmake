@@ -0,0 +1,30 @@
+# Runs COMMAND (a list of the executable and its arguments) in WORKING_DIRECTORY and compares its standard output
+# with the content of EXPECTED_OUTPUT file and its exit code with EXPECTED_RESULT. Expected outputs are those of
+# GNU coreutils.
+#
+# Usage: cmake "-DCOMMAND=<executable>;<argument>..." -DWORKING_DIRECTORY=<directory> -DEXPECTED_OUTPUT=<file>
+#              -DEXPECTED_RESULT=<code> -P run_test.cmake
+
+cmake_minimum_required(VERSION 3.28)
+
+foreach (required COMMAND WORKING_DIRECTORY EXPECTED_OUTPUT EXPECTED_RESULT)
+    if (NOT DEFINED ${required})
+        message(FATAL_ERROR "${required} must be defined")
+    endif()
+endforeach()
+
+execute_process(
+    COMMAND ${COMMAND}
+    WORKING_DIRECTORY ${WORKING_DIRECTORY}
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE errors
+    RESULT_VARIABLE result
+)
+file(READ ${EXPECTED_OUTPUT} expected)
+
+if (NOT result STREQUAL EXPECTED_RESULT)
+    message(FATAL_ERROR "Exit code ${result}, expected ${EXPECTED_RESULT}\nOutput:\n${output}\nErrors:\n${errors}")
+endif()
+if (NOT output STREQUAL expected)
+    message(FATAL_ERROR "Output:\n${output}\nExpected:\n${expected}\nErrors:\n${errors}")
+endif()